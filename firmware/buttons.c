@@ -16,18 +16,43 @@
  * along with this program. If not, see http://www.gnu.org/licenses/
  *
  */
+/*
+ * The buttons aren't polled from the main loop, but sampled and debounced
+ * from the system tick interrupt. The pin change interrupts of their ports
+ * record the time of the first edge of every press and release. Each
+ * debounced state change is queued as event together with that time, and
+ * handed over to the callback functions from the main loop. So no matter
+ * how long the main loop takes, the time of each press and release is
+ * known exactly.
+ */
 #include <stdio.h>
 #include <stdint.h>
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <util/atomic.h>
 #include "buttons.h"
 #include "menu.h"
 #include "playback.h"
+#include "ring.h"
+#include "timer.h"
+#include "uart.h"
+
+static const char button_queue_string[] PROGMEM = "Button queue: ";
+static const char button_bounce_string[] PROGMEM = "Button bounces:";
+
+/* system ticks between two button samples for the debounce time */
+#define BUTTON_SAMPLE_TICKS \
+    ((TIMER_MS(BUTTON_DEBOUNCE_MS) + BUTTON_DEBOUNCE_SAMPLES - 1) / BUTTON_DEBOUNCE_SAMPLES)
 
 
-/* internal button states */
-typedef enum {
-    STATE_RELEASED,
-    STATE_PRESSED
-} button_state;
+/* menu "Select" button hold time to store the current setup as default */
+#define MENU_LONG_PRESS         TIMER_MS(1500)
+/* menu "<" and ">" button auto repeat periods while held down */
+#define MENU_REPEAT_SLOW        TIMER_MS(500)
+#define MENU_REPEAT_FAST        TIMER_MS(100)
+/* number of slow auto repeats before speeding up */
+#define MENU_REPEAT_SLOW_COUNT  3
 
 /* button handler callback function */
 typedef void (*button_callback_t)(void *);
@@ -42,138 +67,418 @@ struct button_handler {
     volatile uint8_t *port;
     /* controller port pin number connected to button */
     uint8_t pin;
-    /* internal state of button */
-    button_state state;
-    /* previous state of button */
-    button_state laststate;
-    /* button release and press callback handlers */
-    union {
-        button_callback_t callbacks[2];
-        struct {
-            button_callback_t released_cb;
-            button_callback_t pressed_cb;
-        };
-    };
+    /* button event callback handlers, indexed by button_event_t */
+    button_callback_t callbacks[BUTTON_EVENT_MAX];
     /* button specific argument passed to callback handlers */
     void *callback_arg;
+    /* hold time in system ticks until the long press event, 0 for none */
+    uint16_t long_press;
+    /* hold time in system ticks until the first repeat event, 0 for none */
+    uint16_t repeat_delay;
+    /* system ticks between the following repeat events */
+    uint16_t repeat_period;
+    /* number of repeat events before switching to repeat_fast_period */
+    uint8_t repeat_fast_count;
+    /* system ticks between the repeat events after repeat_fast_count */
+    uint16_t repeat_fast_period;
 };
 
-/* set up button handling and callbacks */
+/* set up button handling, callbacks, and hold timing */
 static struct button_handler button_handlers[BUTTON_MAX] = {
     {   /* BUTTON_MENU_PREV */
         .callbacks = {
-            menu_button_release,
-            menu_button_press
+            [BUTTON_EVENT_PRESS] = menu_button_press,
+            [BUTTON_EVENT_REPEAT] = menu_button_repeat
         },
         .callback_arg = (menu_button_t *) MENU_BUTTON_PREV,
+        .repeat_delay = MENU_REPEAT_SLOW,
+        .repeat_period = MENU_REPEAT_SLOW,
+        .repeat_fast_count = MENU_REPEAT_SLOW_COUNT,
+        .repeat_fast_period = MENU_REPEAT_FAST
     },
     {   /* BUTTON_MENU_SELECT */
         .callbacks = {
-            menu_button_release,
-            menu_button_press
+            [BUTTON_EVENT_PRESS] = menu_button_press,
+            [BUTTON_EVENT_LONG_PRESS] = menu_button_long_press
         },
         .callback_arg = (menu_button_t *) MENU_BUTTON_SELECT,
+        .long_press = MENU_LONG_PRESS
     },
     {   /* BUTTON_MENU_NEXT */
         .callbacks = {
-            menu_button_release,
-            menu_button_press
+            [BUTTON_EVENT_PRESS] = menu_button_press,
+            [BUTTON_EVENT_REPEAT] = menu_button_repeat
         },
         .callback_arg = (menu_button_t *) MENU_BUTTON_NEXT,
+        .repeat_delay = MENU_REPEAT_SLOW,
+        .repeat_period = MENU_REPEAT_SLOW,
+        .repeat_fast_count = MENU_REPEAT_SLOW_COUNT,
+        .repeat_fast_period = MENU_REPEAT_FAST
     },
     {   /* BUTTON_CHORD_I */
         .callbacks = {
-            playback_button_release,
-            playback_button_press,
+            [BUTTON_EVENT_RELEASE] = playback_button_release,
+            [BUTTON_EVENT_PRESS] = playback_button_press
         },
         .callback_arg = (uint8_t *) 0
     },
     {   /* BUTTON_CHORD_V */
         .callbacks = {
-            playback_button_release,
-            playback_button_press,
+            [BUTTON_EVENT_RELEASE] = playback_button_release,
+            [BUTTON_EVENT_PRESS] = playback_button_press
         },
         .callback_arg = (uint8_t *) 1
     },
     {   /* BUTTON_CHORD_vi */
         .callbacks = {
-            playback_button_release,
-            playback_button_press,
+            [BUTTON_EVENT_RELEASE] = playback_button_release,
+            [BUTTON_EVENT_PRESS] = playback_button_press
         },
         .callback_arg = (uint8_t *) 2
     },
     {   /* BUTTON_CHORD_IV */
         .callbacks = {
-            playback_button_release,
-            playback_button_press,
+            [BUTTON_EVENT_RELEASE] = playback_button_release,
+            [BUTTON_EVENT_PRESS] = playback_button_press
         },
         .callback_arg = (uint8_t *) 3
     }
 };
 
+/*
+ * Hold timing state of each button, only used in the system tick.
+ * System ticks left until the long press and the next repeat event, 0 if
+ * none is due, and the number of repeat events since the button press.
+ */
+static uint16_t hold_long_press[BUTTON_MAX];
+static uint16_t hold_repeat[BUTTON_MAX];
+static uint8_t hold_repeats[BUTTON_MAX];
+
+
+/*
+ * Button event queue. Each event holds the button name in the lower bits,
+ * and the button_event_t value in the upper bits.
+ */
+static uint8_t event_buf[BUTTON_QUEUE_SIZE];
+static ring_t event_ring = RING_INIT(event_buf);
+#define EVENT_BUTTON_MASK   0x0f
+#define EVENT_TYPE_SHIFT    4
+/* system tick of each queued event, stored in the same slot as the event */
+static uint16_t event_stamps[BUTTON_QUEUE_SIZE];
+
+/* system tick of the event currently handled by a callback function */
+static uint16_t event_stamp;
+/* set while a callback function handles an event */
+static uint8_t event_active;
+
+/*
+ * Debounced button states and vertical counters, one bit per button.
+ *
+ * Each button has its own two bit counter, with the lower bits of all
+ * counters packed in one byte, and the upper bits in another. A counter
+ * counts the samples in which its button's raw state differs from the
+ * debounced one, and is reset whenever they match again. Only after
+ * BUTTON_DEBOUNCE_SAMPLES such samples in a row, the debounced state is
+ * changed. This way, all buttons are handled at once with a few bitwise
+ * operations, no matter how many are bouncing.
+ */
+/* debounced button states, bit set if pressed */
+static uint8_t debounced;
+/* lower and upper bits of each button's vertical counter */
+static uint8_t counter_low = 0xff;
+static uint8_t counter_high = 0xff;
+/* raw button states of the previous sample */
+static uint8_t last_raw;
+/* system ticks until the next sample */
+static uint8_t sample_ticks;
+/* number of raw state changes that didn't last, per button */
+static uint16_t bounces[BUTTON_MAX];
+
+/*
+ * Time of the first raw edge of each button since its last debounced state
+ * change, recorded by the pin change interrupts. Valid if the button's bit
+ * is set in edge_stamped.
+ */
+static uint16_t edge_stamps[BUTTON_MAX];
+static volatile uint8_t edge_stamped;
+
 
 /**
- * Poll all active mapped input ports.
- * Sets interal state of button handlers according to current button state.
+ * Read the raw state of all active mapped input ports.
+ * @return Raw button states, bit set if the button's input reads pressed
  */
-static void
-buttons_poll(void)
+static uint8_t
+buttons_read(void)
 {
-    uint8_t i;
     struct button_handler *handler;
+    uint8_t raw = 0;
+    uint8_t i;
 
     for (i = 0; i < BUTTON_MAX; i++) {
         handler = &button_handlers[i];
         if (handler->active && (*handler->port & (1 << handler->pin)) == 0) {
-            handler->state = STATE_PRESSED;
-        } else {
-            handler->state = STATE_RELEASED;
+            raw |= (1 << i);
         }
     }
-}
 
+    return raw;
+}
 
 /**
- * Handle all active buttons after polling.
- * If button port is active and has a callback function for the current state,
- * the callback function is called.
+ * Record the time of a button's first edge away from its debounced state.
+ * The debouncing itself delays every state change, so the debounced event
+ * gets the time of the edge that started it instead. Called from the pin
+ * change interrupts, which don't block other interrupts to keep V-USB happy.
  */
 static void
-buttons_handle(void)
+buttons_edge(void)
 {
+    uint16_t now = timer_get_systick();
+    uint8_t edges = (buttons_read() ^ debounced) & ~edge_stamped;
     uint8_t i;
+
+    if (edges == 0) {
+        return;
+    }
+
+    for (i = 0; i < BUTTON_MAX; i++) {
+        if (edges & (1 << i)) {
+            edge_stamps[i] = now;
+        }
+    }
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        edge_stamped |= edges;
+    }
+}
+
+/**
+ * Pin change interrupt handler for port B.
+ */
+ISR(PCINT0_vect, ISR_NOBLOCK)
+{
+    buttons_edge();
+}
+
+/**
+ * Pin change interrupt handler for port C.
+ */
+ISR(PCINT1_vect, ISR_NOBLOCK)
+{
+    buttons_edge();
+}
+
+/**
+ * Pin change interrupt handler for port D.
+ */
+ISR(PCINT2_vect, ISR_NOBLOCK)
+{
+    buttons_edge();
+}
+
+/**
+ * Queue a button event.
+ * @param button Button name
+ * @param event Button event
+ * @param stamp System tick the event happened at
+ */
+static void
+button_event_put(uint8_t button, button_event_t event, uint16_t stamp)
+{
+    /* with the ring full, the slot still holds the oldest unread event */
+    if (ring_count(&event_ring) <= event_ring.mask) {
+        event_stamps[ring_put_slot(&event_ring)] = stamp;
+    }
+    ring_put(&event_ring, button | (event << EVENT_TYPE_SHIFT));
+}
+
+/**
+ * Count down a button's hold time until its next long press or repeat event.
+ * @param ticks Pointer to the remaining hold time, 0 if no event is due
+ * @return 1 if the event is due now, 0 otherwise
+ */
+static uint8_t
+hold_countdown(uint16_t *ticks)
+{
+    if (*ticks == 0) {
+        return 0;
+    }
+
+    if (*ticks <= BUTTON_SAMPLE_TICKS) {
+        *ticks = 0;
+        return 1;
+    }
+
+    *ticks -= BUTTON_SAMPLE_TICKS;
+    return 0;
+}
+
+/**
+ * Button system tick handler.
+ * Samples all buttons every BUTTON_SAMPLE_TICKS system ticks and runs them
+ * through the vertical counter debouncing. Every debounced state change is
+ * queued as press or release event together with the time of its first
+ * edge. While a button is held down, its long press and repeat events are
+ * queued according to the button's hold timing. Called from the system
+ * tick interrupt handler.
+ */
+void
+buttons_systick(void)
+{
     struct button_handler *handler;
+    uint16_t stamp;
+    uint8_t raw;
+    uint8_t changed;
+    uint8_t bounced;
+    uint8_t i;
+
+    if (sample_ticks > 0) {
+        sample_ticks--;
+        return;
+    }
+    sample_ticks = BUTTON_SAMPLE_TICKS - 1;
+
+    raw = buttons_read();
+    /* raw edges straight back to the debounced state didn't last */
+    bounced = (raw ^ last_raw) & ~(raw ^ debounced);
+    last_raw = raw;
+
+    /* count while raw and debounced state differ, reset otherwise */
+    changed = raw ^ debounced;
+    counter_low = ~(counter_low & changed);
+    counter_high = counter_low ^ (counter_high & changed);
+    /* buttons whose counter rolled over change their debounced state */
+    changed &= counter_low & counter_high;
+    debounced ^= changed;
 
     for (i = 0; i < BUTTON_MAX; i++) {
-        handler = &button_handlers[i];
+        if (bounced & (1 << i)) {
+            bounces[i]++;
+        }
+
+        if (changed & (1 << i)) {
+            stamp = (edge_stamped & (1 << i)) ? edge_stamps[i] : timer_get_systick();
+
+            if (debounced & (1 << i)) {
+                handler = &button_handlers[i];
+                hold_long_press[i] = handler->long_press;
+                hold_repeat[i] = handler->repeat_delay;
+                hold_repeats[i] = 0;
+                button_event_put(i, BUTTON_EVENT_PRESS, stamp);
+            } else {
+                hold_long_press[i] = 0;
+                hold_repeat[i] = 0;
+                button_event_put(i, BUTTON_EVENT_RELEASE, stamp);
+            }
+
+        } else if (debounced & (1 << i)) {
+            handler = &button_handlers[i];
+
+            if (hold_countdown(&hold_long_press[i])) {
+                button_event_put(i, BUTTON_EVENT_LONG_PRESS, timer_get_systick());
+            }
 
-        if (handler->active && handler->callbacks[handler->state]) {
-            if (handler->state != handler->laststate ||
-               (handler->state == STATE_PRESSED))
-            {
-                handler->callbacks[handler->state](&handler->callback_arg);
+            if (hold_countdown(&hold_repeat[i])) {
+                button_event_put(i, BUTTON_EVENT_REPEAT, timer_get_systick());
+                if (hold_repeats[i] < handler->repeat_fast_count) {
+                    hold_repeats[i]++;
+                }
+                hold_repeat[i] = (hold_repeats[i] < handler->repeat_fast_count)
+                        ? handler->repeat_period : handler->repeat_fast_period;
             }
         }
-        handler->laststate = handler->state;
+    }
+
+    /* the edges of every button that settled are done with */
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        edge_stamped &= raw ^ debounced;
+    }
+}
+
+
+/**
+ * Handle all queued button events.
+ * If the event's button is active and has a callback function for the
+ * event, the callback function is called, once per event.
+ */
+static void
+buttons_handle(void)
+{
+    struct button_handler *handler;
+    button_callback_t callback;
+    uint8_t event;
+
+    while (ring_count(&event_ring) > 0) {
+        event_stamp = event_stamps[ring_get_slot(&event_ring)];
+        ring_get(&event_ring, &event);
+        handler = &button_handlers[event & EVENT_BUTTON_MASK];
+        callback = handler->callbacks[event >> EVENT_TYPE_SHIFT];
+
+        if (handler->active && callback) {
+            event_active = 1;
+            callback(&handler->callback_arg);
+            event_active = 0;
+        }
     }
 }
 
 
 /**
  * Button input loop function.
- * Polls all mapped buttons and handles press/release callback functions.
- * Call this from inside the main loop.
+ * Calls the button callback functions for all queued button events, i.e.
+ * once per press and release, and for the long press and repeat events of
+ * held buttons. Call this from inside the main loop.
  */
 void
 button_input_loop(void)
 {
-    buttons_poll();
     buttons_handle();
 }
 
 
+/**
+ * Get the time of the button event currently handled.
+ * Called from within a callback function, this is the time of the button's
+ * first edge, no matter how long the event waited in the queue. Outside of
+ * the callbacks, e.g. for chord changes entered via UART, it's the current
+ * system tick.
+ *
+ * @return System tick the button changed its state at
+ */
+uint16_t
+button_event_time(void)
+{
+    return event_active ? event_stamp : timer_get_systick();
+}
+
+
+/**
+ * Print the button event queue statistics via UART.
+ * Also shows how many times each button bounced, in button_name order.
+ */
+void
+buttons_print_stats(void)
+{
+    uint16_t count;
+    uint8_t i;
+
+    ring_print_stats(button_queue_string, &event_ring);
+
+    uart_print_pgm(button_bounce_string);
+    for (i = 0; i < BUTTON_MAX; i++) {
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            count = bounces[i];
+        }
+        uart_putchar(' ');
+        uart_putint(count, 1);
+    }
+    uart_newline();
+}
+
+
 /**
  * Map controller input port pin to internal button handler.
+ * Also enables the pin change interrupt for the given port pin.
  *
  * @param button Button name to assign based on button_name enumeration
  * @param port   Pointer to input port as defined in <avr/io.h>
@@ -191,6 +496,18 @@ button_map_port(button_name button, volatile uint8_t *port, uint8_t pin)
     button_handlers[button].pin  = pin;
     button_handlers[button].active = 1;
 
+    /* enable the pin change interrupt of the button's port and pin */
+    if (port == &PINB) {
+        PCMSK0 |= (1 << pin);
+        PCICR  |= (1 << PCIE0);
+    } else if (port == &PINC) {
+        PCMSK1 |= (1 << pin);
+        PCICR  |= (1 << PCIE1);
+    } else if (port == &PIND) {
+        PCMSK2 |= (1 << pin);
+        PCICR  |= (1 << PCIE2);
+    }
+
     return 0;
 }
 
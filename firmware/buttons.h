@@ -34,9 +34,33 @@ typedef enum {
     BUTTON_MAX
 } button_name;
 
+/**
+ * Button event enumeration.
+ */
+typedef enum {
+    /* button got released */
+    BUTTON_EVENT_RELEASE,
+    /* button got pressed */
+    BUTTON_EVENT_PRESS,
+    /* button is held down for its long press time, sent once per press */
+    BUTTON_EVENT_LONG_PRESS,
+    /* button is still held down, sent periodically after the first delay */
+    BUTTON_EVENT_REPEAT,
+    BUTTON_EVENT_MAX
+} button_event_t;
+
+/* number of button events the event queue can hold, power of 2 */
+#define BUTTON_QUEUE_SIZE 8
+
+/* time in ms a button state change needs to last to be accepted */
+#define BUTTON_DEBOUNCE_MS 8
+/* number of samples within the debounce time, fixed by the 2 bit counters */
+#define BUTTON_DEBOUNCE_SAMPLES 4
+
 
 /**
  * Map controller input port pin to internal button handler.
+ * Also enables the pin change interrupt for the given port pin.
  *
  * @param button Button name to assign based on button_name enumeration
  * @param port   Pointer to input port as defined in <avr/io.h>
@@ -47,10 +71,39 @@ int8_t button_map_port(button_name button, volatile uint8_t *port, uint8_t pin);
 
 /**
  * Button input loop function.
- * Polls all mapped buttons and handles press/release callback functions.
- * Call this from inside the main loop.
+ * Calls the button callback functions for all queued button events, i.e.
+ * once per press and release, and for the long press and repeat events of
+ * held buttons. Call this from inside the main loop.
  */
 void button_input_loop(void);
 
+/**
+ * Get the time of the button event currently handled.
+ * Called from within a callback function, this is the time of the button's
+ * first edge, no matter how long the event waited in the queue. Outside of
+ * the callbacks, e.g. for chord changes entered via UART, it's the current
+ * system tick.
+ *
+ * @return System tick the button changed its state at
+ */
+uint16_t button_event_time(void);
+
+/**
+ * Button system tick handler.
+ * Samples all buttons every BUTTON_SAMPLE_TICKS system ticks and runs them
+ * through the vertical counter debouncing. Every debounced state change is
+ * queued as press or release event together with the time of its first
+ * edge. While a button is held down, its long press and repeat events are
+ * queued according to the button's hold timing. Called from the system
+ * tick interrupt handler.
+ */
+void buttons_systick(void);
+
+/**
+ * Print the button event queue statistics via UART.
+ * Also shows how many times each button bounced, in button_name order.
+ */
+void buttons_print_stats(void);
+
 #endif
 
@@ -19,10 +19,15 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <avr/pgmspace.h>
+#include "buttons.h"
+#include "clock.h"
 #include "config.h"
 #include "menu.h"
+#include "pattern.h"
 #include "playback.h"
+#include "timer.h"
 #include "uart.h"
+#include "usb.h"
 
 /* 4chord MIDI banner */
 static const char cli_banner[] PROGMEM =
@@ -46,10 +51,46 @@ static const char cli_help[] PROGMEM =
     [<]     Menu previous\r\n\
   [Enter]   Menu Select\r\n\
     [>]     Menu next\r\n\
+    [,]     Tempo -0.1 BPM\r\n\
+    [.]     Tempo +0.1 BPM\r\n\
+    [u]     Show USB MIDI queue statistics\r\n\
+    [q]     Show event queue statistics\r\n\
+    [i]     Select next USB poll interval\r\n\
+    [l]     Toggle USB latency measurement\r\n\
+    [c]     Select next MIDI clock mode\r\n\
+    [p]     Stop / continue MIDI clock transport\r\n\
+    [g]     Select next gate length for current mode\r\n\
+    [e]     Edit user pattern\r\n\
+    [v]     Select next chord inversion\r\n\
+    [7]     Toggle added seventh\r\n\
+    [V]     Toggle voice leading\r\n\
+    [r]     Select next chord release (note off / sustain)\r\n\
+    [Q]     Select next chord change quantization (off / beat / bar)\r\n\
     [h]     Print this help\r\n\
     [?]     About 4chord MIDI\r\n\
 ";
 
+/* User pattern editor help text */
+static const char cli_edit_help[] PROGMEM =
+"\r\n\
+User pattern editor, enter up to 8 steps of chord tones to play:\r\n\
+    [r]     Root\r\n\
+    [t]     Third\r\n\
+    [f]     Fifth\r\n\
+    [o]     Octave\r\n\
+  [Space]   Next step, a step without tones is a rest\r\n\
+  [Enter]   Store pattern, store no steps to delete it\r\n\
+   [Esc]    Cancel\r\n\
+";
+
+static const char cli_edit_slot_string[] PROGMEM = "\r\nUser pattern slot [1-8]: ";
+static const char cli_edit_current_string[] PROGMEM = "\r\nCurrent: ";
+static const char cli_edit_steps_string[] PROGMEM = "\r\nSteps:   ";
+static const char cli_edit_stored_string[] PROGMEM = "\r\nPattern stored\r\n";
+static const char cli_edit_deleted_string[] PROGMEM = "\r\nPattern deleted\r\n";
+static const char cli_edit_cancel_string[] PROGMEM = "\r\nCancelled\r\n";
+static const char cli_edit_empty_string[] PROGMEM = "(empty)";
+
 /* 4chord MIDI about text */
 static const char cli_about[] PROGMEM =
 "\r\n\r\n\
@@ -68,22 +109,201 @@ static uint8_t button = NO_BUTTON;
 
 /* command data read from UART */
 static char cmd;
-/* last command data read from UART */
-static char last;
+
+/* user pattern editor states */
+typedef enum {
+    EDIT_NONE,
+    EDIT_SLOT,
+    EDIT_STEPS
+} edit_state_t;
+
+#define KEY_ESC 0x1b
+
+/* chord tone characters, in order of the PATTERN_* chord tone bits */
+static const char tone_chars[CHORD_TONES] = {'r', 't', 'f', 'o'};
+
+/* current user pattern editor state */
+static edit_state_t edit_state;
+/* user pattern slot being edited */
+static uint8_t edit_slot;
+/* number of steps entered so far */
+static uint8_t edit_length;
+/* chord tones of the step currently being entered */
+static uint8_t edit_tones;
+/* set if the step currently being entered has any input */
+static uint8_t edit_pending;
+/* user pattern steps entered so far */
+static pattern_step_t edit_steps[PATTERN_STEPS_MAX];
 
 
 static void
 playback_handle(uint8_t new_button)
 {
-    if (button != NO_BUTTON) {
-        playback_button_release(&button);
+    uint8_t old_button = button;
+
+    if (old_button != NO_BUTTON && old_button == new_button) {
+        /* same chord again, retrigger it */
+        playback_button_release(&old_button);
+        playback_button_press(&button);
+        return;
     }
 
     button = new_button;
 
+    /* press the new chord first, so the playback switches right over to it */
     if (button != NO_BUTTON) {
         playback_button_press(&button);
     }
+
+    if (old_button != NO_BUTTON) {
+        playback_button_release(&old_button);
+    }
+}
+
+
+/**
+ * Print the chord tone characters of a given PATTERN_* bit mask.
+ * @param tones Chord tones bit mask
+ */
+static void
+edit_print_tones(uint8_t tones)
+{
+    uint8_t tone;
+
+    for (tone = 0; tone < CHORD_TONES; tone++) {
+        if (tones & (1 << tone)) {
+            uart_putchar(tone_chars[tone]);
+        }
+    }
+}
+
+/**
+ * Print the steps of the user pattern in the currently edited slot.
+ */
+static void
+edit_print_pattern(void)
+{
+    playback_mode_item_t mode = PLAYBACK_MODE_USER + edit_slot;
+    uint8_t length = pattern_get_length(mode);
+    pattern_step_t step;
+    uint8_t i;
+
+    uart_print_pgm(cli_edit_current_string);
+    if (length == 0) {
+        uart_print_pgm(cli_edit_empty_string);
+    }
+
+    for (i = 0; i < length; i++) {
+        pattern_get_step(mode, i, &step);
+        edit_print_tones(step.on);
+        uart_putchar(' ');
+    }
+}
+
+/**
+ * Add the step currently being entered to the edited pattern.
+ */
+static void
+edit_add_step(void)
+{
+    if (edit_length < PATTERN_STEPS_MAX) {
+        edit_steps[edit_length].on = edit_tones;
+        edit_steps[edit_length].velocity = PATTERN_VELOCITY;
+        edit_length++;
+    }
+    edit_tones = 0;
+    edit_pending = 0;
+}
+
+/**
+ * Store the edited pattern and leave the editor.
+ * Each step stops the tones of the previous one that it doesn't start
+ * again itself, with the first step following up on the last one.
+ */
+static void
+edit_finish(void)
+{
+    uint8_t prev;
+    uint8_t i;
+
+    if (edit_pending) {
+        edit_add_step();
+    }
+
+    for (i = 0; i < edit_length; i++) {
+        prev = (i == 0) ? edit_length - 1 : i - 1;
+        edit_steps[i].off = edit_steps[prev].on & ~edit_steps[i].on;
+    }
+
+    pattern_user_store(edit_slot, edit_steps, edit_length);
+    uart_print_pgm((edit_length > 0) ? cli_edit_stored_string : cli_edit_deleted_string);
+
+    menu_playback_mode_check();
+    edit_state = EDIT_NONE;
+}
+
+/**
+ * Handle user pattern editor input.
+ * @param c Character read from UART
+ */
+static void
+edit_handle(char c)
+{
+    uint8_t tone;
+
+    if (c == KEY_ESC) {
+        uart_print_pgm(cli_edit_cancel_string);
+        edit_state = EDIT_NONE;
+        return;
+    }
+
+    if (edit_state == EDIT_SLOT) {
+        if (c >= '1' && c < '1' + PLAYBACK_MODE_USER_MAX) {
+            uart_putchar(c);
+            edit_slot = c - '1';
+            edit_length = 0;
+            edit_tones = 0;
+            edit_pending = 0;
+            edit_print_pattern();
+            uart_print_pgm(cli_edit_steps_string);
+            edit_state = EDIT_STEPS;
+        }
+        return;
+    }
+
+    switch (c) {
+        case ' ':
+            if (edit_length < PATTERN_STEPS_MAX) {
+                uart_putchar(c);
+                edit_add_step();
+            }
+            break;
+        case '\r':
+            edit_finish();
+            break;
+        default:
+            for (tone = 0; tone < CHORD_TONES; tone++) {
+                if (c == tone_chars[tone] && edit_length < PATTERN_STEPS_MAX) {
+                    uart_putchar(c);
+                    edit_tones |= (1 << tone);
+                    edit_pending = 1;
+                }
+            }
+            break;
+    }
+}
+
+/**
+ * Start the user pattern editor.
+ * Stops any ongoing playback, as the edited pattern may be playing.
+ */
+static void
+edit_start(void)
+{
+    playback_handle(NO_BUTTON);
+    uart_print_pgm(cli_edit_help);
+    uart_print_pgm(cli_edit_slot_string);
+    edit_state = EDIT_SLOT;
 }
 
 
@@ -105,8 +325,12 @@ cli_poll(void)
 {
     cmd = uart_get_inbuf();
 
-    if (cmd != last) {
-        last = cmd;
+    if (cmd) {
+        if (edit_state != EDIT_NONE) {
+            edit_handle(cmd);
+            return;
+        }
+
         switch (cmd) {
             case '1':
             case '2':
@@ -131,6 +355,54 @@ cli_poll(void)
             case 'd':
                 menu_button_next();
                 break;
+            case ',':
+                menu_tempo_fine_down();
+                break;
+            case '.':
+                menu_tempo_fine_up();
+                break;
+            case 'u':
+                usb_midi_print_stats();
+                break;
+            case 'q':
+                uart_print_stats();
+                buttons_print_stats();
+                timer_print_stats();
+                playback_print_stats();
+                break;
+            case 'i':
+                usb_poll_interval_next();
+                break;
+            case 'l':
+                usb_latency_toggle();
+                break;
+            case 'c':
+                clock_mode_next();
+                break;
+            case 'p':
+                clock_transport_toggle();
+                break;
+            case 'g':
+                playback_gate_next();
+                break;
+            case 'e':
+                edit_start();
+                break;
+            case 'v':
+                playback_inversion_next();
+                break;
+            case '7':
+                playback_seventh_toggle();
+                break;
+            case 'V':
+                playback_voice_leading_toggle();
+                break;
+            case 'r':
+                playback_release_next();
+                break;
+            case 'Q':
+                playback_quantize_next();
+                break;
             case 'h':
                 uart_print_pgm(cli_help);
                 break;
@@ -138,7 +410,6 @@ cli_poll(void)
                 uart_print_pgm(cli_about);
                 break;
         }
-        uart_reset_inbuf();
     }
 }
 
@@ -0,0 +1,459 @@
+/*
+ * 4chord MIDI - MIDI clock handling
+ *
+ * Copyright (C) 2020 Sven Gregori <sven@craplab.fi>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/
+ *
+ *
+ * In slave mode, the playback cycles are driven by the MIDI Timing Clock
+ * messages received from the host at 24 pulses per quarter note. Every
+ * 12th pulse advances the playback by one 1/8 note step. A MIDI Start
+ * message resets the playback to the beginning of the bar, Stop halts the
+ * playback cycles until either Start or Continue is received.
+ *
+ * The time between two clock pulses is measured and smoothed out with an
+ * exponential moving average, and the resulting tempo estimate replaces
+ * the menu tempo on the display while in slave mode.
+ *
+ * In internal and master mode, the clock pulses are generated from the
+ * system tick interrupt based on the tempo selected in the menu. Instead of
+ * rounding the pulse interval to whole system ticks, a phase accumulator
+ * adds the tempo on every tick and emits a pulse whenever it overflows a
+ * full pulse period, carrying the remainder over to the next pulse. The
+ * single pulses jitter by at most one system tick, but their long-term
+ * average is exact for every tempo in 0.1 BPM resolution.
+ *
+ * In master mode, the MIDI Timing Clock messages are sent
+ * via the USB interrupt queue, so main loop activities like LCD updates
+ * can't add any jitter to them. In both modes, the playback cycles are
+ * derived from the very same clock pulses. In internal mode, the clock only
+ * runs while a chord button is pressed. Pressing a chord button while the transport is
+ * stopped sends a MIDI Start message, the CLI can stop and continue it.
+ */
+#include <stdint.h>
+#include <avr/eeprom.h>
+#include <avr/pgmspace.h>
+#include <util/atomic.h>
+#include "clock.h"
+#include "eeprom.h"
+#include "gui.h"
+#include "menu.h"
+#include "playback.h"
+#include "timer.h"
+#include "uart.h"
+#include "usb.h"
+
+static const char clock_mode_string[] PROGMEM = "Clock mode: ";
+static const char clock_no_transport_string[] PROGMEM = "Transport control requires clock master mode\r\n";
+static const char *const clock_mode_names[CLOCK_MODE_MAX] = {
+    "internal",
+    "slave",
+    "master"
+};
+
+/*
+ * Weight of a new clock interval in the moving average as power of 2.
+ * The stored average is scaled up by the same value, so with a value of 3,
+ * every new interval is weighted 1/8 against the previous average.
+ */
+#define INTERVAL_AVERAGE_SHIFT 3
+
+/*
+ * Number of timer2 counts in one minute divided by CLOCK_PPQN, i.e. the
+ * clock interval in timer2 counts equals this value divided by the tempo.
+ */
+#define COUNTS_PER_MINUTE_PER_PULSE ((F_CPU >> 6) * 60 / CLOCK_PPQN)
+
+/*
+ * Phase accumulator value of one full clock pulse period.
+ * Adding the tempo in 0.1 BPM times CLOCK_PPQN on every system tick, one
+ * pulse period is the number of system ticks in one minute times 10.
+ */
+#define PHASE_PER_PULSE ((uint32_t) SYSTICK_FREQ * 60 * 10)
+
+/*
+ * Number of system ticks of one playback cycle step (1/8 note) at a tempo
+ * of 0.1 BPM, i.e. the step duration equals this value divided by the tempo
+ * in 0.1 BPM.
+ */
+#define STEP_TICKS_PER_TEMPO ((uint32_t) SYSTICK_FREQ * 60 * 10 / 2)
+
+/* currently selected clock mode */
+static volatile clock_mode_t clock_mode;
+/* set while the clock transport is running, i.e. between Start and Stop */
+static volatile uint8_t running;
+/* clock pulse counter within the current playback cycle step */
+static volatile uint8_t pulse;
+/*
+ * set from the transport start until its first pulse, which the chord
+ * button press already played the step for
+ */
+static volatile uint8_t start_pulse;
+/* system tick of the last playback cycle step */
+static volatile uint16_t step_stamp;
+/* phase accumulator, a clock pulse is due when reaching PHASE_PER_PULSE */
+static volatile uint32_t phase;
+/* phase increment per system tick, set from the menu tempo */
+static volatile uint16_t phase_step;
+/* menu tempo in 0.1 BPM the phase increment was calculated for */
+static uint16_t phase_tempo;
+/* timestamp of the last received clock pulse */
+static uint16_t last_stamp;
+/* set if last_stamp is valid and the next interval can be measured */
+static uint8_t have_stamp;
+/* moving average of the clock interval, scaled by INTERVAL_AVERAGE_SHIFT */
+static uint32_t interval_average;
+/*
+ * tempo estimated from the clock interval, clamped to the playback tempo
+ * range, 0 if there is no estimate
+ */
+static uint8_t tempo_estimate;
+/* tempo estimate currently shown on the display */
+static uint8_t tempo_shown;
+
+
+/**
+ * Initialize the MIDI clock handling.
+ * Reads the clock mode setting from the EEPROM.
+ */
+void
+clock_init(void)
+{
+    clock_mode = eeprom_read_byte(&eeprom_data.settings.clock_mode);
+
+    if (clock_mode >= CLOCK_MODE_MAX) {
+        clock_mode = CLOCK_MODE_INTERNAL;
+        eeprom_update_byte(&eeprom_data.settings.clock_mode, clock_mode);
+    }
+}
+
+/**
+ * Get the current clock mode.
+ * @return Current clock mode
+ */
+clock_mode_t
+clock_get_mode(void)
+{
+    return clock_mode;
+}
+
+/**
+ * Select the next clock mode.
+ * Cycles through all clock modes and stores the new mode in the EEPROM.
+ */
+void
+clock_mode_next(void)
+{
+    if (++clock_mode == CLOCK_MODE_MAX) {
+        clock_mode = 0;
+    }
+    eeprom_update_byte(&eeprom_data.settings.clock_mode, clock_mode);
+
+    if (running && clock_mode == CLOCK_MODE_INTERNAL) {
+        /* leaving master mode, let the receivers know the clock stops */
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            usb_send_midi_realtime(MIDI_STOP);
+        }
+    }
+
+    running = 0;
+    have_stamp = 0;
+    tempo_estimate = 0;
+    tempo_shown = 0;
+
+    /* switching modes, show the menu tempo again */
+    gui_set_playback_tempo(menu_get_current_playback_tempo());
+
+    uart_print_pgm(clock_mode_string);
+    uart_print((char *) clock_mode_names[clock_mode]);
+    uart_newline();
+}
+
+/**
+ * Measure the time since the last clock pulse and update the tempo estimate.
+ */
+static void
+clock_measure(void)
+{
+    uint16_t now = timer_get_timestamp();
+    uint16_t interval = now - last_stamp;
+    uint32_t tempo;
+
+    last_stamp = now;
+
+    if (!have_stamp) {
+        have_stamp = 1;
+        return;
+    }
+
+    if (interval_average == 0) {
+        /* first measured interval, use as is */
+        interval_average = (uint32_t) interval << INTERVAL_AVERAGE_SHIFT;
+    } else {
+        interval_average += interval;
+        interval_average -= interval_average >> INTERVAL_AVERAGE_SHIFT;
+    }
+
+    tempo = (((uint32_t) COUNTS_PER_MINUTE_PER_PULSE << INTERVAL_AVERAGE_SHIFT)
+            + (interval_average >> 1)) / interval_average;
+
+    /* the step timing and the display only cover the playback tempo range */
+    if (tempo < PLAYBACK_TEMPO_MIN) {
+        tempo = PLAYBACK_TEMPO_MIN;
+    } else if (tempo > PLAYBACK_TEMPO_MAX) {
+        tempo = PLAYBACK_TEMPO_MAX;
+    }
+    tempo_estimate = tempo;
+}
+
+/**
+ * Handle a received MIDI System Real-Time message.
+ * Called from the USB MIDI OUT endpoint handler. Timing Clock, Start,
+ * Continue, and Stop messages are handled if the clock mode is set to
+ * CLOCK_MODE_SLAVE, any other message is ignored.
+ *
+ * @param status MIDI status byte of the received message
+ */
+void
+clock_midi_realtime(uint8_t status)
+{
+    if (clock_mode != CLOCK_MODE_SLAVE) {
+        return;
+    }
+
+    switch (status) {
+        case MIDI_TIMING_CLOCK:
+            clock_measure();
+            if (running) {
+                if (pulse == 0) {
+                    step_stamp = timer_get_systick();
+                    playback_clock_step();
+                }
+                if (++pulse == CLOCK_PULSES_PER_STEP) {
+                    pulse = 0;
+                }
+            }
+            break;
+
+        case MIDI_START:
+            /* next clock pulse is the first beat of the bar */
+            pulse = 0;
+            playback_clock_start();
+            running = 1;
+            break;
+
+        case MIDI_CONTINUE:
+            running = 1;
+            break;
+
+        case MIDI_STOP:
+            running = 0;
+            break;
+    }
+}
+
+/**
+ * Start the clock transport in internal or master mode.
+ * Restarts the clock pulses, so that the next pulse marks the first beat of
+ * the bar. In master mode, a MIDI Start message is sent ahead of it.
+ */
+void
+clock_transport_start(void)
+{
+    if (clock_mode == CLOCK_MODE_SLAVE) {
+        return;
+    }
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        if (clock_mode == CLOCK_MODE_MASTER) {
+            usb_send_midi_realtime(MIDI_START);
+        }
+        /* first pulse right on the next system tick */
+        phase = PHASE_PER_PULSE - phase_step;
+        pulse = 0;
+        start_pulse = 1;
+        running = 1;
+        /* the button press plays the first step itself */
+        step_stamp = timer_get_systick();
+    }
+}
+
+/**
+ * Stop the clock transport in internal or master mode.
+ * In master mode, a MIDI Stop message is sent.
+ */
+void
+clock_transport_stop(void)
+{
+    if (clock_mode == CLOCK_MODE_SLAVE) {
+        return;
+    }
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        if (clock_mode == CLOCK_MODE_MASTER && running) {
+            usb_send_midi_realtime(MIDI_STOP);
+        }
+        running = 0;
+    }
+}
+
+/**
+ * Toggle the MIDI clock transport in master mode.
+ * Sends a MIDI Stop message if the transport is running, and a Continue
+ * message if it is stopped.
+ */
+void
+clock_transport_toggle(void)
+{
+    if (clock_mode != CLOCK_MODE_MASTER) {
+        uart_print_pgm(clock_no_transport_string);
+        return;
+    }
+
+    if (running) {
+        clock_transport_stop();
+    } else {
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            usb_send_midi_realtime(MIDI_CONTINUE);
+            running = 1;
+        }
+    }
+}
+
+/**
+ * Check if the MIDI clock transport is running.
+ * @return 1 if the transport is running, 0 if it is stopped
+ */
+uint8_t
+clock_transport_running(void)
+{
+    return running;
+}
+
+/**
+ * Get the duration of a single playback cycle step, i.e. a 1/8 note.
+ * Based on the menu tempo, or on the estimated tempo in slave mode.
+ * @return Playback cycle step duration in system ticks
+ */
+uint16_t
+clock_step_ticks(void)
+{
+    uint16_t tempo = menu_get_current_playback_tempo_tenths();
+
+    if (clock_mode == CLOCK_MODE_SLAVE && tempo_estimate != 0) {
+        tempo = tempo_estimate * 10;
+    }
+
+    return STEP_TICKS_PER_TEMPO / tempo;
+}
+
+/**
+ * Estimate the time until the next playback cycle step.
+ * Based on the time of the last step and the current step duration, so in
+ * slave mode, it's only as good as the tempo estimate.
+ * @return System ticks until the next step, 0 if it is due already
+ */
+uint16_t
+clock_step_remaining(void)
+{
+    uint16_t step = clock_step_ticks();
+    uint16_t elapsed;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        elapsed = timer_get_systick() - step_stamp;
+    }
+
+    return (elapsed < step) ? step - elapsed : 0;
+}
+
+/**
+ * Get the time the current playback cycle step started at.
+ * @return System tick of the last step
+ */
+uint16_t
+clock_step_start(void)
+{
+    uint16_t stamp;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        stamp = step_stamp;
+    }
+
+    return stamp;
+}
+
+/**
+ * MIDI clock system tick handler.
+ * Generates the clock pulses at 24 pulses per quarter note in internal and
+ * master mode, and advances the playback every 12th pulse while the
+ * transport is running. In master mode, every pulse is sent as MIDI Timing
+ * Clock message. Called from the system tick interrupt handler.
+ */
+void
+clock_systick(void)
+{
+    if (clock_mode == CLOCK_MODE_SLAVE) {
+        return;
+    }
+
+    phase += phase_step;
+    if (phase < PHASE_PER_PULSE) {
+        return;
+    }
+    phase -= PHASE_PER_PULSE;
+
+    if (clock_mode == CLOCK_MODE_MASTER) {
+        usb_send_midi_realtime(MIDI_TIMING_CLOCK);
+    }
+
+    if (running) {
+        if (start_pulse) {
+            /* the chord button press itself plays the first step of the bar */
+            start_pulse = 0;
+        } else if (pulse == 0) {
+            step_stamp = timer_get_systick();
+            playback_clock_step();
+        }
+        if (++pulse == CLOCK_PULSES_PER_STEP) {
+            pulse = 0;
+        }
+    }
+}
+
+/**
+ * MIDI clock poll function.
+ * Updates the tempo display with the tempo estimated from the incoming
+ * MIDI clock messages when in slave mode, and adjusts the clock phase
+ * increment to the selected tempo otherwise. Call this from the main loop.
+ */
+void
+clock_poll(void)
+{
+    uint16_t tempo = menu_get_current_playback_tempo_tenths();
+
+    if (tempo != phase_tempo) {
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            phase_step = tempo * CLOCK_PPQN;
+        }
+        phase_tempo = tempo;
+    }
+
+    if (clock_mode == CLOCK_MODE_SLAVE && tempo_estimate != tempo_shown &&
+            tempo_estimate >= PLAYBACK_TEMPO_MIN &&
+            tempo_estimate <= PLAYBACK_TEMPO_MAX)
+    {
+        tempo_shown = tempo_estimate;
+        gui_set_playback_tempo(tempo_shown);
+    }
+}
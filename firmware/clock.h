@@ -0,0 +1,138 @@
+/*
+ * 4chord MIDI - MIDI clock handling
+ *
+ * Copyright (C) 2020 Sven Gregori <sven@craplab.fi>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/
+ *
+ */
+#ifndef _CLOCK_H_
+#define _CLOCK_H_
+#include <stdint.h>
+
+/* MIDI clock pulses per quarter note */
+#define CLOCK_PPQN 24
+
+/* MIDI clock pulses per playback cycle, i.e. per 1/8 note */
+#define CLOCK_PULSES_PER_STEP (CLOCK_PPQN / 2)
+
+/* MIDI System Real-Time messages */
+#define MIDI_TIMING_CLOCK   0xf8
+#define MIDI_START          0xfa
+#define MIDI_CONTINUE       0xfb
+#define MIDI_STOP           0xfc
+
+/* Clock mode list */
+typedef enum {
+    /* tempo from the menu, playback cycles driven by the system tick */
+    CLOCK_MODE_INTERNAL,
+    /* tempo and playback cycles driven by incoming MIDI clock messages */
+    CLOCK_MODE_SLAVE,
+    /* menu tempo, playback cycles and MIDI clock output driven by systick */
+    CLOCK_MODE_MASTER,
+    CLOCK_MODE_MAX
+} clock_mode_t;
+
+/**
+ * Initialize the MIDI clock handling.
+ * Reads the clock mode setting from the EEPROM.
+ */
+void clock_init(void);
+
+/**
+ * Get the current clock mode.
+ * @return Current clock mode
+ */
+clock_mode_t clock_get_mode(void);
+
+/**
+ * Select the next clock mode.
+ * Cycles through all clock modes and stores the new mode in the EEPROM.
+ */
+void clock_mode_next(void);
+
+/**
+ * Handle a received MIDI System Real-Time message.
+ * Called from the USB MIDI OUT endpoint handler. Timing Clock, Start,
+ * Continue, and Stop messages are handled if the clock mode is set to
+ * CLOCK_MODE_SLAVE, any other message is ignored.
+ *
+ * @param status MIDI status byte of the received message
+ */
+void clock_midi_realtime(uint8_t status);
+
+/**
+ * Start the clock transport in internal or master mode.
+ * Restarts the clock pulses, so that the next pulse marks the first beat of
+ * the bar. In master mode, a MIDI Start message is sent ahead of it.
+ */
+void clock_transport_start(void);
+
+/**
+ * Stop the clock transport in internal or master mode.
+ * In master mode, a MIDI Stop message is sent.
+ */
+void clock_transport_stop(void);
+
+/**
+ * Toggle the MIDI clock transport in master mode.
+ * Sends a MIDI Stop message if the transport is running, and a Continue
+ * message if it is stopped.
+ */
+void clock_transport_toggle(void);
+
+/**
+ * Check if the MIDI clock transport is running.
+ * @return 1 if the transport is running, 0 if it is stopped
+ */
+uint8_t clock_transport_running(void);
+
+/**
+ * Get the duration of a single playback cycle step, i.e. a 1/8 note.
+ * Based on the menu tempo, or on the estimated tempo in slave mode.
+ * @return Playback cycle step duration in system ticks
+ */
+uint16_t clock_step_ticks(void);
+
+/**
+ * Estimate the time until the next playback cycle step.
+ * Based on the time of the last step and the current step duration, so in
+ * slave mode, it's only as good as the tempo estimate.
+ * @return System ticks until the next step, 0 if it is due already
+ */
+uint16_t clock_step_remaining(void);
+
+/**
+ * Get the time the current playback cycle step started at.
+ * @return System tick of the last step
+ */
+uint16_t clock_step_start(void);
+
+/**
+ * MIDI clock system tick handler.
+ * Generates the clock pulses at 24 pulses per quarter note in internal and
+ * master mode, and advances the playback every 12th pulse while the
+ * transport is running. In master mode, every pulse is sent as MIDI Timing
+ * Clock message. Called from the system tick interrupt handler.
+ */
+void clock_systick(void);
+
+/**
+ * MIDI clock poll function.
+ * Updates the tempo display with the tempo estimated from the incoming
+ * MIDI clock messages when in slave mode, and adjusts the clock phase
+ * increment to the selected tempo otherwise. Call this from the main loop.
+ */
+void clock_poll(void);
+
+#endif
@@ -32,6 +32,15 @@
 /* SPI data/command pin number */
 #define SPI_DC_PIN  PB1
 
+/*
+ * SPI double speed, clocking the LCD at F_CPU/2 instead of F_CPU/4.
+ * At 12MHz that's above the 4MHz the PCD8544 datasheet specifies, so it's
+ * off by default. Boards whose display is known to cope can enable it.
+ */
+#ifndef SPI_DOUBLE_SPEED
+#define SPI_DOUBLE_SPEED 0
+#endif
+
 /* LCD reset port name */
 #define LCD_RESET_PORT  PORTB
 /* LCD reset pin number */
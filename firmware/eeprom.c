@@ -20,7 +20,10 @@
 #include <avr/pgmspace.h>
 #include "eeprom.h"
 #include "menu.h"
+#include "pattern.h"
+#include "playback.h"
 #include "uart.h"
+#include "usbconfig.h"
 #include "lcd.h"
 
 /**
@@ -29,7 +32,7 @@
  * eeprom_data_t struct that either require a defined default value,
  * or the firmware expects to have a specific / initialized value.
  */
-static const uint8_t EEPROM_VERSION = 1;
+static const uint8_t EEPROM_VERSION = 9;
 
 /**
  * Default initialization values for EEPROM.
@@ -56,6 +59,21 @@ struct eeprom_data_t eeprom_data EEMEM = {
         .mode  = PLAYBACK_MODE_CHORD,
         .metre = PLAYBACK_METRE_4_4,
         .tempo = PLAYBACK_TEMPO_DEFAULT,
+        .tempo_tenth = 0,
+    },
+    .settings = {
+        .usb_poll_interval = USB_CFG_INTR_POLL_INTERVAL,
+        .clock_mode = CLOCK_MODE_INTERNAL,
+        .gate = {
+            PLAYBACK_GATE_DEFAULT,
+            PLAYBACK_GATE_DEFAULT,
+            PLAYBACK_GATE_DEFAULT,
+            PLAYBACK_GATE_DEFAULT,
+            PLAYBACK_GATE_DEFAULT,
+        },
+        .voicing = 0,
+        .release = PLAYBACK_RELEASE_NOTE_OFF,
+        .quantize = PLAYBACK_QUANTIZE_OFF,
     },
 };
 
@@ -107,6 +125,33 @@ check_header_magic(void)
             eeprom_read_byte(&eeprom_data.header.magic[3]) == 0x0d);
 }
 
+/**
+ * Restores the default gate length of all playback modes.
+ */
+static void
+restore_gate_defaults(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < PLAYBACK_MODE_USER; i++) {
+        eeprom_update_byte(&eeprom_data.settings.gate[i], PLAYBACK_GATE_DEFAULT);
+    }
+}
+
+/**
+ * Clears the user pattern directory, leaving all user pattern slots empty.
+ */
+static void
+restore_user_pattern_defaults(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < PLAYBACK_MODE_USER_MAX; i++) {
+        eeprom_update_byte(&eeprom_data.user_patterns.directory[i].length, 0);
+        eeprom_update_byte(&eeprom_data.user_patterns.directory[i].gate, PLAYBACK_GATE_DEFAULT);
+    }
+}
+
 /**
  * Restores the EEPROM data with default values.
  */
@@ -128,6 +173,15 @@ restore_defaults(void)
     eeprom_update_byte(&eeprom_data.defaults.mode, PLAYBACK_MODE_CHORD);
     eeprom_update_byte(&eeprom_data.defaults.metre, PLAYBACK_METRE_4_4);
     eeprom_update_byte(&eeprom_data.defaults.tempo, PLAYBACK_TEMPO_DEFAULT);
+    eeprom_update_byte(&eeprom_data.defaults.tempo_tenth, 0);
+
+    eeprom_update_byte(&eeprom_data.settings.usb_poll_interval, USB_CFG_INTR_POLL_INTERVAL);
+    eeprom_update_byte(&eeprom_data.settings.clock_mode, CLOCK_MODE_INTERNAL);
+    eeprom_update_byte(&eeprom_data.settings.voicing, 0);
+    eeprom_update_byte(&eeprom_data.settings.release, PLAYBACK_RELEASE_NOTE_OFF);
+    eeprom_update_byte(&eeprom_data.settings.quantize, PLAYBACK_QUANTIZE_OFF);
+    restore_gate_defaults();
+    restore_user_pattern_defaults();
 }
 
 /**
@@ -184,6 +238,78 @@ static void check_update(void)
             eeprom_update_byte(&eeprom_data.board_data.lcd.tcoeff, LCD_DEFAULT_TCOEFF);
             eeprom_update_byte(&eeprom_data.board_data.lcd.bias, LCD_DEFAULT_BIAS);
             eeprom_update_byte(&eeprom_data.board_data.lcd.vop, LCD_DEFAULT_VOP);
+            /* fall through */
+        case 0x01:
+            /*
+             * Update to version 2
+             *
+             * Changes: Added settings struct for device settings
+             * Update:  Set default USB interrupt endpoint poll interval
+             */
+            eeprom_update_byte(&eeprom_data.settings.usb_poll_interval, USB_CFG_INTR_POLL_INTERVAL);
+            /* fall through */
+        case 0x02:
+            /*
+             * Update to version 3
+             *
+             * Changes: Added settings.clock_mode for MIDI clock handling
+             * Update:  Set internal clock mode
+             */
+            eeprom_update_byte(&eeprom_data.settings.clock_mode, CLOCK_MODE_INTERNAL);
+            /* fall through */
+        case 0x03:
+            /*
+             * Update to version 4
+             *
+             * Changes: Added defaults.tempo_tenth for 0.1 BPM tempo resolution
+             * Update:  Set no fine adjustment
+             */
+            eeprom_update_byte(&eeprom_data.defaults.tempo_tenth, 0);
+            /* fall through */
+        case 0x04:
+            /*
+             * Update to version 5
+             *
+             * Changes: Added settings.gate for per playback mode note length
+             * Update:  Set default gate length for all playback modes
+             */
+            restore_gate_defaults();
+            /* fall through */
+        case 0x05:
+            /*
+             * Update to version 6
+             *
+             * Changes: Added user_patterns struct for user playback patterns
+             * Update:  Clear the user pattern directory
+             */
+            restore_user_pattern_defaults();
+            /* fall through */
+        case 0x06:
+            /*
+             * Update to version 7
+             *
+             * Changes: Added settings.voicing for chord inversions and sevenths
+             * Update:  Set root position triads
+             */
+            eeprom_update_byte(&eeprom_data.settings.voicing, 0);
+            /* fall through */
+        case 0x07:
+            /*
+             * Update to version 8
+             *
+             * Changes: Added settings.release for the chord release strategy
+             * Update:  Set separate note offs
+             */
+            eeprom_update_byte(&eeprom_data.settings.release, PLAYBACK_RELEASE_NOTE_OFF);
+            /* fall through */
+        case 0x08:
+            /*
+             * Update to version 9
+             *
+             * Changes: Added settings.quantize for beat-quantized chord changes
+             * Update:  Set chord changes unquantized
+             */
+            eeprom_update_byte(&eeprom_data.settings.quantize, PLAYBACK_QUANTIZE_OFF);
     }
 
     /* Update EEPROM data with latest version number */
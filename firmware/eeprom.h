@@ -20,7 +20,10 @@
 #define _EEPROM_H_
 #include <stdint.h>
 #include <avr/eeprom.h>
+#include "clock.h"
 #include "menu.h"
+#include "pattern.h"
+#include "playback.h"
 
 extern struct eeprom_data_t {
     /* EEPROM header, for identification and sanity check (16 bytes) */
@@ -61,10 +64,33 @@ extern struct eeprom_data_t {
         playback_mode_item_t mode;          /* 0x32 */
         playback_metre_item_t metre;        /* 0x33 */
         playback_tempo_item_t tempo;        /* 0x34 */
-        uint8_t __defaults_reserved[11];    /* 0x35 */
+        uint8_t tempo_tenth;                /* 0x35 */
+        uint8_t __defaults_reserved[10];    /* 0x36 */
     } defaults;
 
-    /* unused (960 bytes) */                /* 0x40 */
+    /* device settings (16 bytes) */
+    struct {
+        /* USB interrupt endpoint poll interval in ms */
+        uint8_t usb_poll_interval;          /* 0x40 */
+        clock_mode_t clock_mode;            /* 0x41 */
+        /* note length in percent per playback mode */
+        uint8_t gate[PLAYBACK_MODE_USER];   /* 0x42 */
+        /* chord inversion and added seventh, PLAYBACK_VOICING_* values */
+        uint8_t voicing;                    /* 0x47 */
+        playback_release_t release;         /* 0x48 */
+        playback_quantize_t quantize;       /* 0x49 */
+        uint8_t __settings_reserved[6];     /* 0x4a */
+    } settings;
+
+    /* user programmable playback patterns (144 bytes) */
+    struct {
+        /* length and note length of each user pattern slot */
+        pattern_dir_entry_t directory[PLAYBACK_MODE_USER_MAX];          /* 0x50 */
+        /* steps of each user pattern slot */
+        pattern_packed_step_t steps[PLAYBACK_MODE_USER_MAX][PATTERN_STEPS_MAX];  /* 0x60 */
+    } user_patterns;
+
+    /* unused (800 bytes) */                /* 0xe0 */
 } eeprom_data EEMEM;
 
 /**
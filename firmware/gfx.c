@@ -1,358 +1,316 @@
 /*
- * gfx full graphics set
+ * gfx compressed graphics set
  * auto-generated by xbmtool.sh
  */
 #include <avr/pgmspace.h>
 #include <stdint.h>
 #include "gfx.h"
 
-/* full frame for key_a.xbm */
+/* rle frame for key_a.xbm */
 const uint8_t gfx_key_a[] PROGMEM = {
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xc0, 0xe0, 
-        0xf0, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 
-        0xe0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0xc0, 0xf0, 0xf8, 0xfe, 0xff, 0x7f, 0x1f, 
-        0x0f, 0x03, 0x01, 0x07, 0xff, 0xff, 0xff, 0xff, 
-        0xff, 0xfc, 0xc0, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0x00, 0x80, 0xc0, 0xf0, 0xf8, 0xfe, 
-        0xff, 0xff, 0xff, 0xff, 0xf3, 0xf1, 0xf0, 0xf0, 
-        0xf0, 0xf0, 0xf0, 0xf0, 0xf0, 0xff, 0xff, 0xff, 
-        0xff, 0xff, 0xff, 0xf8, 0x80, 0x00, 0x00, 0x00, 
-        0x00, 0x0c, 0x0e, 0x0f, 0x0f, 0x0f, 0x07, 0x03, 
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x0f, 
-        0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x00, 0x00, 0x00, 
+        TYPE_RLE,
+        0x8c, 0x00, 0x02, 0xc0, 0xe0, 0xf0, 0x85, 0xf8, 
+        0x00, 0xe0, 0x8e, 0x00, 0x0a, 0xc0, 0xf0, 0xf8, 
+        0xfe, 0xff, 0x7f, 0x1f, 0x0f, 0x03, 0x01, 0x07, 
+        0x83, 0xff, 0x01, 0xfc, 0xc0, 0x86, 0x00, 0x04, 
+        0x80, 0xc0, 0xf0, 0xf8, 0xfe, 0x82, 0xff, 0x01, 
+        0xf3, 0xf1, 0x85, 0xf0, 0x84, 0xff, 0x01, 0xf8, 
+        0x80, 0x82, 0x00, 0x01, 0x0c, 0x0e, 0x81, 0x0f, 
+        0x01, 0x07, 0x03, 0x8c, 0x00, 0x00, 0x01, 0x84, 
+        0x0f, 0x81, 0x00, 
 };
 
-/* full frame for key_b.xbm */
+/* rle frame for key_b.xbm */
 const uint8_t gfx_key_b[] PROGMEM = {
-        0x00, 0x00, 0x00, 0x00, 0x00, 0xe0, 0xf8, 0xf8, 
-        0xf8, 0xf8, 0xf8, 0x78, 0x78, 0x78, 0x78, 0x78, 
-        0x78, 0x78, 0x78, 0x78, 0x78, 0xf8, 0xf8, 0xf0, 
-        0xf0, 0xf0, 0xe0, 0xe0, 0x80, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0x00, 0xc0, 0xfe, 0xff, 0xff, 0xff, 
-        0xff, 0xef, 0xe0, 0xe0, 0xe0, 0xe0, 0xe0, 0xe0, 
-        0xe0, 0xe0, 0xe0, 0xe0, 0xf0, 0xb0, 0xb8, 0xbd, 
-        0x1f, 0x1f, 0x0f, 0x0f, 0x07, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0xf8, 0xff, 0xff, 0xff, 0xff, 0x3f, 
-        0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0x01, 0x81, 0x81, 0xc3, 0xe7, 0xff, 
-        0xff, 0xff, 0xfe, 0x7c, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 
-        0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 
-        0x0f, 0x0f, 0x0f, 0x07, 0x07, 0x07, 0x03, 0x03, 
-        0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+        TYPE_RLE,
+        0x83, 0x00, 0x00, 0xe0, 0x83, 0xf8, 0x88, 0x78, 
+        0x01, 0xf8, 0xf8, 0x81, 0xf0, 0x02, 0xe0, 0xe0, 
+        0x80, 0x84, 0x00, 0x01, 0xc0, 0xfe, 0x82, 0xff, 
+        0x00, 0xef, 0x88, 0xe0, 0x08, 0xf0, 0xb0, 0xb8, 
+        0xbd, 0x1f, 0x1f, 0x0f, 0x0f, 0x07, 0x83, 0x00, 
+        0x00, 0xf8, 0x82, 0xff, 0x01, 0x3f, 0x01, 0x87, 
+        0x00, 0x04, 0x01, 0x81, 0x81, 0xc3, 0xe7, 0x81, 
+        0xff, 0x01, 0xfe, 0x7c, 0x83, 0x00, 0x90, 0x0f, 
+        0x81, 0x07, 0x03, 0x03, 0x03, 0x01, 0x01, 0x84, 
+        0x00, 
 };
 
-/* full frame for key_c.xbm */
+/* rle frame for key_c.xbm */
 const uint8_t gfx_key_c[] PROGMEM = {
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 
-        0xc0, 0xc0, 0xe0, 0xe0, 0xf0, 0xf0, 0x70, 0x70, 
-        0x38, 0x38, 0x38, 0x38, 0x38, 0x38, 0x38, 0x78, 
-        0x78, 0xf8, 0xf0, 0xf0, 0x70, 0x00, 0x00, 0x00, 
-        0x00, 0x80, 0xe0, 0xf8, 0xfc, 0xfe, 0xff, 0x3f, 
-        0x0f, 0x07, 0x03, 0x01, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0x0f, 0x3f, 0xff, 0xff, 0xff, 0xff, 0xf0, 
-        0xc0, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 
-        0xc0, 0xc0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x03, 0x03, 
-        0x07, 0x07, 0x0f, 0x0f, 0x0f, 0x0e, 0x0e, 0x0e, 
-        0x0e, 0x0e, 0x0e, 0x0e, 0x0f, 0x07, 0x07, 0x07, 
-        0x03, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+        TYPE_RLE,
+        0x85, 0x00, 0x08, 0x80, 0xc0, 0xc0, 0xe0, 0xe0, 
+        0xf0, 0xf0, 0x70, 0x70, 0x85, 0x38, 0x05, 0x78, 
+        0x78, 0xf8, 0xf0, 0xf0, 0x70, 0x82, 0x00, 0x0a, 
+        0x80, 0xe0, 0xf8, 0xfc, 0xfe, 0xff, 0x3f, 0x0f, 
+        0x07, 0x03, 0x01, 0x8c, 0x00, 0x01, 0x01, 0x01, 
+        0x83, 0x00, 0x01, 0x0f, 0x3f, 0x82, 0xff, 0x02, 
+        0xf0, 0xc0, 0x80, 0x8b, 0x00, 0x02, 0x80, 0xc0, 
+        0xc0, 0x88, 0x00, 0x05, 0x01, 0x01, 0x03, 0x03, 
+        0x07, 0x07, 0x81, 0x0f, 0x85, 0x0e, 0x00, 0x0f, 
+        0x81, 0x07, 0x01, 0x03, 0x03, 0x84, 0x00, 
 };
 
-/* full frame for key_d.xbm */
+/* rle frame for key_d.xbm */
 const uint8_t gfx_key_d[] PROGMEM = {
-        0x00, 0x00, 0x00, 0x00, 0x00, 0xe0, 0xf8, 0xf8, 
-        0xf8, 0xf8, 0xf8, 0x78, 0x78, 0x78, 0x78, 0x78, 
-        0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0xf8, 0xf8, 
-        0xf0, 0xf0, 0xf0, 0xe0, 0xc0, 0x80, 0x00, 0x00, 
-        0x00, 0x00, 0x00, 0xc0, 0xfe, 0xff, 0xff, 0xff, 
-        0xff, 0x1f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x01, 0x03, 0x8f, 0xff, 0xff, 0xff, 0xff, 0xfc, 
-        0x00, 0x00, 0xf8, 0xff, 0xff, 0xff, 0xff, 0x3f, 
-        0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0x00, 0x80, 0x80, 0x80, 0xc0, 0xe0, 
-        0xf0, 0xfc, 0xff, 0x7f, 0x3f, 0x1f, 0x0f, 0x03, 
-        0x00, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 
-        0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 
-        0x0f, 0x0f, 0x0f, 0x07, 0x07, 0x07, 0x03, 0x03, 
-        0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+        TYPE_RLE,
+        0x83, 0x00, 0x00, 0xe0, 0x83, 0xf8, 0x89, 0x78, 
+        0x01, 0xf8, 0xf8, 0x81, 0xf0, 0x02, 0xe0, 0xc0, 
+        0x80, 0x83, 0x00, 0x01, 0xc0, 0xfe, 0x82, 0xff, 
+        0x00, 0x1f, 0x8c, 0x00, 0x02, 0x01, 0x03, 0x8f, 
+        0x82, 0xff, 0x03, 0xfc, 0x00, 0x00, 0xf8, 0x82, 
+        0xff, 0x01, 0x3f, 0x03, 0x88, 0x00, 0x81, 0x80, 
+        0x0a, 0xc0, 0xe0, 0xf0, 0xfc, 0xff, 0x7f, 0x3f, 
+        0x1f, 0x0f, 0x03, 0x00, 0x90, 0x0f, 0x81, 0x07, 
+        0x03, 0x03, 0x03, 0x01, 0x01, 0x84, 0x00, 
 };
 
-/* full frame for key_e.xbm */
+/* rle frame for key_e.xbm */
 const uint8_t gfx_key_e[] PROGMEM = {
-        0x00, 0x00, 0x00, 0x00, 0x00, 0xe0, 0xf8, 0xf8, 
-        0xf8, 0xf8, 0xf8, 0x38, 0x38, 0x38, 0x38, 0x38, 
-        0x38, 0x38, 0x38, 0x38, 0x38, 0x38, 0x38, 0x38, 
-        0x38, 0x38, 0x38, 0x38, 0x38, 0x18, 0x00, 0x00, 
-        0x00, 0x00, 0x00, 0xc0, 0xfc, 0xff, 0xff, 0xff, 
-        0xff, 0xff, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 
-        0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 
-        0xc0, 0xc0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0xf8, 0xff, 0xff, 0xff, 0xff, 0x7f, 
-        0x03, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 
-        0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 
-        0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0e, 
-        0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 
-        0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 
-        0x0e, 0x0e, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+        TYPE_RLE,
+        0x83, 0x00, 0x00, 0xe0, 0x83, 0xf8, 0x90, 0x38, 
+        0x00, 0x18, 0x83, 0x00, 0x01, 0xc0, 0xfc, 0x83, 
+        0xff, 0x8e, 0xc0, 0x86, 0x00, 0x00, 0xf8, 0x82, 
+        0xff, 0x01, 0x7f, 0x03, 0x8f, 0x01, 0x85, 0x00, 
+        0x84, 0x0f, 0x91, 0x0e, 0x84, 0x00, 
 };
 
-/* full frame for key_flat.xbm */
+/* rle frame for key_flat.xbm */
 const uint8_t gfx_key_flat[] PROGMEM = {
-        0x00, 0x00, 0x00, 0x80, 0xf8, 0xf8, 0xf8, 0xc0, 
-        0xc0, 0xc0, 0xc0, 0x80, 0x80, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0xf8, 0xff, 0x7f, 0xc3, 0xc0, 0xc0, 
-        0xc0, 0x60, 0x7d, 0x3f, 0x1f, 0x00, 0x00, 0x00, 
+        TYPE_RLE,
+        0x81, 0x00, 0x00, 0x80, 0x81, 0xf8, 0x82, 0xc0, 
+        0x01, 0x80, 0x80, 0x83, 0x00, 0x03, 0xf8, 0xff, 
+        0x7f, 0xc3, 0x81, 0xc0, 0x03, 0x60, 0x7d, 0x3f, 
+        0x1f, 0x81, 0x00, 
 };
 
-/* full frame for key_f.xbm */
+/* rle frame for key_f.xbm */
 const uint8_t gfx_key_f[] PROGMEM = {
-        0x00, 0x00, 0x00, 0x00, 0x00, 0xe0, 0xf8, 0xf8, 
-        0xf8, 0xf8, 0xf8, 0x38, 0x38, 0x38, 0x38, 0x38, 
-        0x38, 0x38, 0x38, 0x38, 0x38, 0x38, 0x38, 0x38, 
-        0x38, 0x38, 0x38, 0x38, 0x38, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0x00, 0xc0, 0xfc, 0xff, 0xff, 0xff, 
-        0xff, 0xdf, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 
-        0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 
-        0xc0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0xf8, 0xff, 0xff, 0xff, 0xff, 0x7f, 
-        0x03, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 
-        0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x07, 0x00, 
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+        TYPE_RLE,
+        0x83, 0x00, 0x00, 0xe0, 0x83, 0xf8, 0x90, 0x38, 
+        0x84, 0x00, 0x01, 0xc0, 0xfc, 0x82, 0xff, 0x00, 
+        0xdf, 0x8d, 0xc0, 0x87, 0x00, 0x00, 0xf8, 0x82, 
+        0xff, 0x01, 0x7f, 0x03, 0x8d, 0x01, 0x87, 0x00, 
+        0x83, 0x0f, 0x00, 0x07, 0x97, 0x00, 
 };
 
-/* full frame for key_g.xbm */
+/* rle frame for key_g.xbm */
 const uint8_t gfx_key_g[] PROGMEM = {
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 
-        0xc0, 0xc0, 0xe0, 0xe0, 0xe0, 0xf0, 0x70, 0x70, 
-        0x38, 0x38, 0x38, 0x38, 0x38, 0x38, 0x38, 0x78, 
-        0x78, 0xf8, 0xf0, 0xf0, 0xf0, 0x60, 0x00, 0x00, 
-        0x00, 0x80, 0xe0, 0xf8, 0xfc, 0xfe, 0xff, 0x7f, 
-        0x0f, 0x07, 0x03, 0x01, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 
-        0xc0, 0xc0, 0xc1, 0xc3, 0x41, 0x00, 0x00, 0x00, 
-        0x00, 0x0f, 0x3f, 0xff, 0xff, 0xff, 0xff, 0xf0, 
-        0xc0, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0x01, 0x01, 0x01, 0xc1, 0xfd, 0xff, 
-        0xff, 0xff, 0xff, 0x07, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x03, 0x03, 
-        0x07, 0x07, 0x0f, 0x0f, 0x0e, 0x0e, 0x0e, 0x0e, 
-        0x0e, 0x0e, 0x0e, 0x0e, 0x0f, 0x07, 0x07, 0x07, 
-        0x07, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+        TYPE_RLE,
+        0x85, 0x00, 0x02, 0x80, 0xc0, 0xc0, 0x81, 0xe0, 
+        0x02, 0xf0, 0x70, 0x70, 0x85, 0x38, 0x02, 0x78, 
+        0x78, 0xf8, 0x81, 0xf0, 0x00, 0x60, 0x81, 0x00, 
+        0x0a, 0x80, 0xe0, 0xf8, 0xfc, 0xfe, 0xff, 0x7f, 
+        0x0f, 0x07, 0x03, 0x01, 0x84, 0x00, 0x86, 0xc0, 
+        0x02, 0xc1, 0xc3, 0x41, 0x82, 0x00, 0x01, 0x0f, 
+        0x3f, 0x82, 0xff, 0x02, 0xf0, 0xc0, 0x80, 0x86, 
+        0x00, 0x81, 0x01, 0x01, 0xc1, 0xfd, 0x82, 0xff, 
+        0x00, 0x07, 0x86, 0x00, 0x07, 0x01, 0x01, 0x03, 
+        0x03, 0x07, 0x07, 0x0f, 0x0f, 0x86, 0x0e, 0x00, 
+        0x0f, 0x82, 0x07, 0x00, 0x03, 0x84, 0x00, 
 };
 
-/* full frame for key_none.xbm */
+/* key diff frame for key_none.xbm */
 const uint8_t gfx_key_none[] PROGMEM = {
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+        TYPE_KEY_DIFF, 0x00, 0,
 };
 
-/* full frame for key_sharp.xbm */
+/* rle frame for key_sharp.xbm */
 const uint8_t gfx_key_sharp[] PROGMEM = {
-        0x00, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xe0, 
-        0xf0, 0xd8, 0xc0, 0xc0, 0xe0, 0xf8, 0xc8, 0xc0, 
-        0x18, 0x98, 0xf8, 0x38, 0x1c, 0x1f, 0x9b, 0xf8, 
-        0x38, 0x1c, 0x1f, 0x19, 0x18, 0x18, 0x18, 0x08, 
+        TYPE_RLE,
+        0x00, 0x00, 0x84, 0xc0, 0x14, 0xe0, 0xf0, 0xd8, 
+        0xc0, 0xc0, 0xe0, 0xf8, 0xc8, 0xc0, 0x18, 0x98, 
+        0xf8, 0x38, 0x1c, 0x1f, 0x9b, 0xf8, 0x38, 0x1c, 
+        0x1f, 0x19, 0x81, 0x18, 0x00, 0x08, 
 };
 
-/* full frame for menu_key.xbm */
+/* rle frame for menu_key.xbm */
 const uint8_t gfx_menu_key[] PROGMEM = {
-        0x80, 0xa0, 0x9e, 0x99, 0xa4, 0x90, 0xac, 0xac, 
-        0xac, 0x80, 0xfc, 0x90, 0x8c, 0x80, 0x00, 0x00, 
-        0x00, 0x3c, 0x04, 0x3c, 0x04, 0x3c, 0x10, 0x2c, 
-        0x24, 0x1c, 0x10, 0x2c, 0x24, 0x3c, 0x13, 0x2c, 
-        0x2c, 0x2c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3e, 
-        0x24, 0x10, 0x2c, 0x2c, 0x2c, 0x00, 0x3c, 0x04, 
-        0x3c, 0x04, 0x3c, 0x60, 0x3c, 0x24, 0x1c, 0x10, 
-        0x2c, 0x24, 0x1c, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x3c, 0x04, 0x3c, 0x04, 0x3c, 0x10, 0x2c, 0x2c, 
-        0x2c, 0x00, 0x3e, 0x24, 0x20, 0x1c, 0x04, 0x10, 
-        0x2c, 0x2c, 0x2c, 0x00, 
+        TYPE_RLE,
+        0x05, 0x80, 0xa0, 0x9e, 0x99, 0xa4, 0x90, 0x81, 
+        0xac, 0x04, 0x80, 0xfc, 0x90, 0x8c, 0x80, 0x81, 
+        0x00, 0x0d, 0x3c, 0x04, 0x3c, 0x04, 0x3c, 0x10, 
+        0x2c, 0x24, 0x1c, 0x10, 0x2c, 0x24, 0x3c, 0x13, 
+        0x81, 0x2c, 0x83, 0x00, 0x02, 0x3e, 0x24, 0x10, 
+        0x81, 0x2c, 0x0d, 0x00, 0x3c, 0x04, 0x3c, 0x04, 
+        0x3c, 0x60, 0x3c, 0x24, 0x1c, 0x10, 0x2c, 0x24, 
+        0x1c, 0x83, 0x00, 0x05, 0x3c, 0x04, 0x3c, 0x04, 
+        0x3c, 0x10, 0x81, 0x2c, 0x06, 0x00, 0x3e, 0x24, 
+        0x20, 0x1c, 0x04, 0x10, 0x81, 0x2c, 0x00, 0x00, 
 };
 
-/* full frame for menu_metre.xbm */
+/* rle frame for menu_metre.xbm */
 const uint8_t gfx_menu_metre[] PROGMEM = {
-        0x00, 0x20, 0x1e, 0x19, 0x24, 0x10, 0x2c, 0x2c, 
-        0x2c, 0x80, 0x7c, 0x10, 0x0c, 0x00, 0x00, 0x00, 
-        0x00, 0x3c, 0x04, 0x3c, 0x04, 0x3c, 0x10, 0x2c, 
-        0x24, 0x1c, 0x10, 0x2c, 0x24, 0x3c, 0x13, 0x2c, 
-        0x2c, 0x2c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3e, 
-        0x24, 0x10, 0x2c, 0x2c, 0x2c, 0x00, 0x3c, 0x04, 
-        0x3c, 0x04, 0x3c, 0x60, 0x3c, 0x24, 0x1c, 0x10, 
-        0x2c, 0x24, 0x1c, 0x00, 0x00, 0x00, 0x00, 0x80, 
-        0xbc, 0x84, 0xbc, 0x84, 0xbc, 0x90, 0xac, 0xac, 
-        0xac, 0x80, 0xbe, 0xa4, 0xa0, 0x9c, 0x84, 0x90, 
-        0xac, 0xac, 0xac, 0x80, 
+        TYPE_RLE,
+        0x05, 0x00, 0x20, 0x1e, 0x19, 0x24, 0x10, 0x81, 
+        0x2c, 0x03, 0x80, 0x7c, 0x10, 0x0c, 0x82, 0x00, 
+        0x0d, 0x3c, 0x04, 0x3c, 0x04, 0x3c, 0x10, 0x2c, 
+        0x24, 0x1c, 0x10, 0x2c, 0x24, 0x3c, 0x13, 0x81, 
+        0x2c, 0x83, 0x00, 0x02, 0x3e, 0x24, 0x10, 0x81, 
+        0x2c, 0x0d, 0x00, 0x3c, 0x04, 0x3c, 0x04, 0x3c, 
+        0x60, 0x3c, 0x24, 0x1c, 0x10, 0x2c, 0x24, 0x1c, 
+        0x82, 0x00, 0x06, 0x80, 0xbc, 0x84, 0xbc, 0x84, 
+        0xbc, 0x90, 0x81, 0xac, 0x06, 0x80, 0xbe, 0xa4, 
+        0xa0, 0x9c, 0x84, 0x90, 0x81, 0xac, 0x00, 0x80, 
 };
 
-/* full frame for menu_mode.xbm */
+/* rle frame for menu_mode.xbm */
 const uint8_t gfx_menu_mode[] PROGMEM = {
-        0x00, 0x20, 0x1e, 0x19, 0x24, 0x10, 0x2c, 0x2c, 
-        0x2c, 0x80, 0x7c, 0x10, 0x0c, 0x00, 0x00, 0x00, 
-        0x80, 0xbc, 0x84, 0xbc, 0x84, 0xbc, 0x90, 0xac, 
-        0xa4, 0x9c, 0x90, 0xac, 0xa4, 0xbc, 0x93, 0xac, 
-        0xac, 0xac, 0x80, 0x00, 0x00, 0x00, 0x00, 0x3e, 
-        0x24, 0x10, 0x2c, 0x2c, 0x2c, 0x00, 0x3c, 0x04, 
+        TYPE_RLE,
+        0x05, 0x00, 0x20, 0x1e, 0x19, 0x24, 0x10, 0x81, 
+        0x2c, 0x03, 0x80, 0x7c, 0x10, 0x0c, 0x81, 0x00, 
+        0x0e, 0x80, 0xbc, 0x84, 0xbc, 0x84, 0xbc, 0x90, 
+        0xac, 0xa4, 0x9c, 0x90, 0xac, 0xa4, 0xbc, 0x93, 
+        0x81, 0xac, 0x00, 0x80, 0x82, 0x00, 0x02, 0x3e, 
+        0x24, 0x10, 0x81, 0x2c, 0x0d, 0x00, 0x3c, 0x04, 
         0x3c, 0x04, 0x3c, 0x60, 0x3c, 0x24, 0x1c, 0x10, 
-        0x2c, 0x24, 0x1c, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x3c, 0x04, 0x3c, 0x04, 0x3c, 0x10, 0x2c, 0x2c, 
-        0x2c, 0x00, 0x3e, 0x24, 0x20, 0x1c, 0x04, 0x10, 
-        0x2c, 0x2c, 0x2c, 0x00, 
+        0x2c, 0x24, 0x1c, 0x83, 0x00, 0x05, 0x3c, 0x04, 
+        0x3c, 0x04, 0x3c, 0x10, 0x81, 0x2c, 0x06, 0x00, 
+        0x3e, 0x24, 0x20, 0x1c, 0x04, 0x10, 0x81, 0x2c, 
+        0x00, 0x00, 
 };
 
-/* full frame for menu_tempo.xbm */
+/* rle frame for menu_tempo.xbm */
 const uint8_t gfx_menu_tempo[] PROGMEM = {
-        0x00, 0x20, 0x1e, 0x19, 0x24, 0x10, 0x2c, 0x2c, 
-        0x2c, 0x80, 0x7c, 0x10, 0x0c, 0x00, 0x00, 0x00, 
-        0x00, 0x3c, 0x04, 0x3c, 0x04, 0x3c, 0x10, 0x2c, 
-        0x24, 0x1c, 0x10, 0x2c, 0x24, 0x3c, 0x13, 0x2c, 
-        0x2c, 0x2c, 0x00, 0x00, 0x00, 0x00, 0x80, 0xbe, 
-        0xa4, 0x90, 0xac, 0xac, 0xac, 0x80, 0xbc, 0x84, 
-        0xbc, 0x84, 0xbc, 0xe0, 0xbc, 0xa4, 0x9c, 0x90, 
-        0xac, 0xa4, 0x9c, 0x80, 0x00, 0x00, 0x00, 0x00, 
-        0x3c, 0x04, 0x3c, 0x04, 0x3c, 0x10, 0x2c, 0x2c, 
-        0x2c, 0x00, 0x3e, 0x24, 0x20, 0x1c, 0x04, 0x10, 
-        0x2c, 0x2c, 0x2c, 0x00, 
+        TYPE_RLE,
+        0x05, 0x00, 0x20, 0x1e, 0x19, 0x24, 0x10, 0x81, 
+        0x2c, 0x03, 0x80, 0x7c, 0x10, 0x0c, 0x82, 0x00, 
+        0x0d, 0x3c, 0x04, 0x3c, 0x04, 0x3c, 0x10, 0x2c, 
+        0x24, 0x1c, 0x10, 0x2c, 0x24, 0x3c, 0x13, 0x81, 
+        0x2c, 0x82, 0x00, 0x03, 0x80, 0xbe, 0xa4, 0x90, 
+        0x81, 0xac, 0x0e, 0x80, 0xbc, 0x84, 0xbc, 0x84, 
+        0xbc, 0xe0, 0xbc, 0xa4, 0x9c, 0x90, 0xac, 0xa4, 
+        0x9c, 0x80, 0x82, 0x00, 0x05, 0x3c, 0x04, 0x3c, 
+        0x04, 0x3c, 0x10, 0x81, 0x2c, 0x06, 0x00, 0x3e, 
+        0x24, 0x20, 0x1c, 0x04, 0x10, 0x81, 0x2c, 0x00, 
+        0x00, 
 };
 
-/* full frame for mode_arp_oct.xbm */
+/* rle frame for mode_arp_oct.xbm */
 const uint8_t gfx_mode_arp_oct[] PROGMEM = {
-        0x92, 0x92, 0x92, 0x92, 0x92, 0x92, 0x92, 0x92, 
-        0x92, 0x92, 0x92, 0x92, 0x92, 0x92, 0x92, 0x92, 
-        0x92, 0x92, 0x92, 0xd2, 0xd2, 0x92, 0x92, 0x92, 
-        0x92, 0x92, 0x92, 0x9e, 0x9e, 0x92, 0x92, 0x92, 
-        0x24, 0x24, 0x24, 0x74, 0x74, 0x24, 0x24, 0x24, 
-        0x24, 0x24, 0x24, 0x2e, 0x2e, 0x24, 0x24, 0x24, 
-        0x24, 0x24, 0x24, 0x25, 0x25, 0x24, 0x24, 0x24, 
-        0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 
+        TYPE_RLE,
+        0x91, 0x92, 0x01, 0xd2, 0xd2, 0x84, 0x92, 0x01, 
+        0x9e, 0x9e, 0x81, 0x92, 0x81, 0x24, 0x01, 0x74, 
+        0x74, 0x84, 0x24, 0x01, 0x2e, 0x2e, 0x84, 0x24, 
+        0x01, 0x25, 0x25, 0x89, 0x24, 
 };
 
-/* full frame for mode_arp.xbm */
+/* rle frame for mode_arp.xbm */
 const uint8_t gfx_mode_arp[] PROGMEM = {
-        0x92, 0x92, 0x92, 0x92, 0x92, 0x92, 0x92, 0x92, 
-        0x92, 0x92, 0x92, 0x92, 0x92, 0x92, 0x92, 0x92, 
-        0x92, 0x92, 0x92, 0xd2, 0xd2, 0x92, 0x92, 0x92, 
-        0x92, 0x92, 0x92, 0x92, 0x92, 0x92, 0x92, 0x92, 
-        0x24, 0x24, 0x24, 0x74, 0x74, 0x24, 0x24, 0x24, 
-        0x24, 0x24, 0x24, 0x2e, 0x2e, 0x24, 0x24, 0x24, 
-        0x24, 0x24, 0x24, 0x25, 0x25, 0x24, 0x24, 0x24, 
-        0x24, 0x24, 0x24, 0x2e, 0x2e, 0x24, 0x24, 0x24, 
+        TYPE_RLE,
+        0x91, 0x92, 0x01, 0xd2, 0xd2, 0x89, 0x92, 0x81, 
+        0x24, 0x01, 0x74, 0x74, 0x84, 0x24, 0x01, 0x2e, 
+        0x2e, 0x84, 0x24, 0x01, 0x25, 0x25, 0x84, 0x24, 
+        0x01, 0x2e, 0x2e, 0x81, 0x24, 
 };
 
-/* full frame for mode_chord_arp_oct.xbm */
+/* rle frame for mode_chord_arp_oct.xbm */
 const uint8_t gfx_mode_chord_arp_oct[] PROGMEM = {
-        0x92, 0x92, 0x92, 0xd2, 0xd2, 0x92, 0x92, 0x92, 
-        0x92, 0x92, 0x92, 0x92, 0x92, 0x92, 0x92, 0x92, 
-        0x92, 0x92, 0x92, 0xd2, 0xd2, 0x92, 0x92, 0x92, 
-        0x92, 0x92, 0x92, 0x9e, 0x9e, 0x92, 0x92, 0x92, 
-        0x24, 0x24, 0x24, 0x7f, 0x7f, 0x24, 0x24, 0x24, 
-        0x24, 0x24, 0x24, 0x2e, 0x2e, 0x24, 0x24, 0x24, 
-        0x24, 0x24, 0x24, 0x25, 0x25, 0x24, 0x24, 0x24, 
-        0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 
+        TYPE_RLE,
+        0x81, 0x92, 0x01, 0xd2, 0xd2, 0x8c, 0x92, 0x01, 
+        0xd2, 0xd2, 0x84, 0x92, 0x01, 0x9e, 0x9e, 0x81, 
+        0x92, 0x81, 0x24, 0x01, 0x7f, 0x7f, 0x84, 0x24, 
+        0x01, 0x2e, 0x2e, 0x84, 0x24, 0x01, 0x25, 0x25, 
+        0x89, 0x24, 
 };
 
-/* full frame for mode_chord_arp.xbm */
+/* rle frame for mode_chord_arp.xbm */
 const uint8_t gfx_mode_chord_arp[] PROGMEM = {
-        0x92, 0x92, 0x92, 0xd2, 0xd2, 0x92, 0x92, 0x92, 
-        0x92, 0x92, 0x92, 0x92, 0x92, 0x92, 0x92, 0x92, 
-        0x92, 0x92, 0x92, 0xd2, 0xd2, 0x92, 0x92, 0x92, 
-        0x92, 0x92, 0x92, 0x92, 0x92, 0x92, 0x92, 0x92, 
-        0x24, 0x24, 0x24, 0x7f, 0x7f, 0x24, 0x24, 0x24, 
-        0x24, 0x24, 0x24, 0x2e, 0x2e, 0x24, 0x24, 0x24, 
-        0x24, 0x24, 0x24, 0x25, 0x25, 0x24, 0x24, 0x24, 
-        0x24, 0x24, 0x24, 0x2e, 0x2e, 0x24, 0x24, 0x24, 
+        TYPE_RLE,
+        0x81, 0x92, 0x01, 0xd2, 0xd2, 0x8c, 0x92, 0x01, 
+        0xd2, 0xd2, 0x89, 0x92, 0x81, 0x24, 0x01, 0x7f, 
+        0x7f, 0x84, 0x24, 0x01, 0x2e, 0x2e, 0x84, 0x24, 
+        0x01, 0x25, 0x25, 0x84, 0x24, 0x01, 0x2e, 0x2e, 
+        0x81, 0x24, 
 };
 
-/* full frame for mode_chord.xbm */
+/* rle frame for mode_chord.xbm */
 const uint8_t gfx_mode_chord[] PROGMEM = {
-        0x92, 0x92, 0x92, 0xd2, 0xd2, 0x92, 0x92, 0x92, 
-        0x92, 0x92, 0x92, 0x92, 0x92, 0x92, 0x92, 0x92, 
-        0x92, 0x92, 0x92, 0x92, 0x92, 0x92, 0x92, 0x92, 
-        0x92, 0x92, 0x92, 0x92, 0x92, 0x92, 0x92, 0x92, 
-        0x24, 0x24, 0x24, 0x7f, 0x7f, 0x24, 0x24, 0x24, 
-        0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 
-        0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 
-        0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 
+        TYPE_RLE,
+        0x81, 0x92, 0x01, 0xd2, 0xd2, 0x99, 0x92, 0x81, 
+        0x24, 0x01, 0x7f, 0x7f, 0x99, 0x24, 
+};
+
+/* rle frame for mode_user.xbm */
+const uint8_t gfx_mode_user[] PROGMEM = {
+        TYPE_RLE,
+        0x81, 0x92, 0x01, 0xba, 0xba, 0x8c, 0x92, 0x01, 
+        0xd2, 0xd2, 0x89, 0x92, 0x89, 0x24, 0x01, 0x2e, 
+        0x2e, 0x84, 0x24, 0x01, 0x25, 0x25, 0x84, 0x24, 
+        0x01, 0x74, 0x74, 0x81, 0x24, 
 };
 
 /* full frame for tempo_0.xbm */
 const uint8_t gfx_tempo_0[] PROGMEM = {
+        TYPE_FULL,
         0xe0, 0xf8, 0x1c, 0x0c, 0x0c, 0x1c, 0xf8, 0xe0, 
         0x07, 0x1f, 0x38, 0x30, 0x30, 0x38, 0x1f, 0x07, 
 };
 
 /* full frame for tempo_1.xbm */
 const uint8_t gfx_tempo_1[] PROGMEM = {
+        TYPE_FULL,
         0x00, 0x30, 0x30, 0x38, 0xfc, 0xfc, 0x00, 0x00, 
         0x00, 0x30, 0x30, 0x30, 0x3f, 0x3f, 0x30, 0x30, 
 };
 
 /* full frame for tempo_2.xbm */
 const uint8_t gfx_tempo_2[] PROGMEM = {
+        TYPE_FULL,
         0x08, 0x1c, 0x0c, 0x0c, 0x8c, 0xf8, 0x78, 0x00, 
         0x38, 0x3c, 0x36, 0x33, 0x31, 0x30, 0x30, 0x30, 
 };
 
 /* full frame for tempo_3.xbm */
 const uint8_t gfx_tempo_3[] PROGMEM = {
+        TYPE_FULL,
         0x08, 0x1c, 0x8c, 0x8c, 0x8c, 0xcc, 0xf8, 0x70, 
         0x38, 0x30, 0x31, 0x31, 0x31, 0x33, 0x1f, 0x0e, 
 };
 
 /* full frame for tempo_4.xbm */
 const uint8_t gfx_tempo_4[] PROGMEM = {
+        TYPE_FULL,
         0x00, 0x80, 0xe0, 0x70, 0x38, 0xfc, 0xfc, 0x00, 
         0x07, 0x07, 0x07, 0x06, 0x06, 0x3f, 0x3f, 0x06, 
 };
 
-/* full frame for tempo_5.xbm */
+/* rle frame for tempo_5.xbm */
 const uint8_t gfx_tempo_5[] PROGMEM = {
-        0x00, 0xfc, 0xfc, 0xcc, 0xcc, 0x8c, 0x8c, 0x0c, 
-        0x30, 0x30, 0x30, 0x30, 0x30, 0x39, 0x1f, 0x0f, 
+        TYPE_RLE,
+        0x07, 0x00, 0xfc, 0xfc, 0xcc, 0xcc, 0x8c, 0x8c, 
+        0x0c, 0x83, 0x30, 0x02, 0x39, 0x1f, 0x0f, 
 };
 
 /* full frame for tempo_6.xbm */
 const uint8_t gfx_tempo_6[] PROGMEM = {
+        TYPE_FULL,
         0xc0, 0xf0, 0xf8, 0xd8, 0xcc, 0x8c, 0x8c, 0x00, 
         0x0f, 0x1f, 0x38, 0x30, 0x30, 0x39, 0x1f, 0x0f, 
 };
 
-/* full frame for tempo_7.xbm */
+/* rle frame for tempo_7.xbm */
 const uint8_t gfx_tempo_7[] PROGMEM = {
-        0x0c, 0x0c, 0x0c, 0xcc, 0xec, 0x3c, 0x1c, 0x00, 
-        0x00, 0x38, 0x3e, 0x07, 0x00, 0x00, 0x00, 0x00, 
+        TYPE_RLE,
+        0x81, 0x0c, 0x08, 0xcc, 0xec, 0x3c, 0x1c, 0x00, 
+        0x00, 0x38, 0x3e, 0x07, 0x82, 0x00, 
 };
 
 /* full frame for tempo_8.xbm */
 const uint8_t gfx_tempo_8[] PROGMEM = {
+        TYPE_FULL,
         0x70, 0xf8, 0xfc, 0x8c, 0x8c, 0x8c, 0xf8, 0x78, 
         0x1e, 0x1f, 0x33, 0x31, 0x31, 0x33, 0x1f, 0x1e, 
 };
 
 /* full frame for tempo_9.xbm */
 const uint8_t gfx_tempo_9[] PROGMEM = {
+        TYPE_FULL,
         0xf0, 0xf8, 0x9c, 0x0c, 0x0c, 0x1c, 0xf8, 0xf0, 
         0x00, 0x31, 0x31, 0x33, 0x1b, 0x1f, 0x0f, 0x03, 
 };
 
-/* full frame for tempo_none.xbm */
+/* key diff frame for tempo_none.xbm */
 const uint8_t gfx_tempo_none[] PROGMEM = {
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+        TYPE_KEY_DIFF, 0x00, 0,
 };
 
@@ -1,69 +1,72 @@
 /*
- * gfx full graphics set
+ * gfx compressed graphics set
  * auto-generated by xbmtool.sh
  */
 #ifndef GFX_H
 #define GFX_H
 #include <stdint.h>
+#include "xbmlib.h"
 
-
-/* full frame for key_a.xbm */
+/* rle frame for key_a.xbm */
 extern const uint8_t gfx_key_a[];
 
-/* full frame for key_b.xbm */
+/* rle frame for key_b.xbm */
 extern const uint8_t gfx_key_b[];
 
-/* full frame for key_c.xbm */
+/* rle frame for key_c.xbm */
 extern const uint8_t gfx_key_c[];
 
-/* full frame for key_d.xbm */
+/* rle frame for key_d.xbm */
 extern const uint8_t gfx_key_d[];
 
-/* full frame for key_e.xbm */
+/* rle frame for key_e.xbm */
 extern const uint8_t gfx_key_e[];
 
-/* full frame for key_flat.xbm */
+/* rle frame for key_flat.xbm */
 extern const uint8_t gfx_key_flat[];
 
-/* full frame for key_f.xbm */
+/* rle frame for key_f.xbm */
 extern const uint8_t gfx_key_f[];
 
-/* full frame for key_g.xbm */
+/* rle frame for key_g.xbm */
 extern const uint8_t gfx_key_g[];
 
-/* full frame for key_none.xbm */
+/* key diff frame for key_none.xbm */
 extern const uint8_t gfx_key_none[];
 
-/* full frame for key_sharp.xbm */
+/* rle frame for key_sharp.xbm */
 extern const uint8_t gfx_key_sharp[];
 
-/* full frame for menu_key.xbm */
+/* rle frame for menu_key.xbm */
 extern const uint8_t gfx_menu_key[];
 
-/* full frame for menu_metre.xbm */
+/* rle frame for menu_metre.xbm */
 extern const uint8_t gfx_menu_metre[];
 
-/* full frame for menu_mode.xbm */
+/* rle frame for menu_mode.xbm */
 extern const uint8_t gfx_menu_mode[];
 
-/* full frame for menu_tempo.xbm */
+/* rle frame for menu_tempo.xbm */
 extern const uint8_t gfx_menu_tempo[];
 
-/* full frame for mode_arp_oct.xbm */
+/* rle frame for mode_arp_oct.xbm */
 extern const uint8_t gfx_mode_arp_oct[];
 
-/* full frame for mode_arp.xbm */
+/* rle frame for mode_arp.xbm */
 extern const uint8_t gfx_mode_arp[];
 
-/* full frame for mode_chord_arp_oct.xbm */
+/* rle frame for mode_chord_arp_oct.xbm */
 extern const uint8_t gfx_mode_chord_arp_oct[];
 
-/* full frame for mode_chord_arp.xbm */
+/* rle frame for mode_chord_arp.xbm */
 extern const uint8_t gfx_mode_chord_arp[];
 
-/* full frame for mode_chord.xbm */
+/* rle frame for mode_chord.xbm */
 extern const uint8_t gfx_mode_chord[];
 
+/* rle frame for mode_user.xbm */
+extern const uint8_t gfx_mode_user[];
+
 /* full frame for tempo_0.xbm */
 extern const uint8_t gfx_tempo_0[];
 
@@ -79,13 +82,13 @@ extern const uint8_t gfx_tempo_3[];
 /* full frame for tempo_4.xbm */
 extern const uint8_t gfx_tempo_4[];
 
-/* full frame for tempo_5.xbm */
+/* rle frame for tempo_5.xbm */
 extern const uint8_t gfx_tempo_5[];
 
 /* full frame for tempo_6.xbm */
 extern const uint8_t gfx_tempo_6[];
 
-/* full frame for tempo_7.xbm */
+/* rle frame for tempo_7.xbm */
 extern const uint8_t gfx_tempo_7[];
 
 /* full frame for tempo_8.xbm */
@@ -94,7 +97,7 @@ extern const uint8_t gfx_tempo_8[];
 /* full frame for tempo_9.xbm */
 extern const uint8_t gfx_tempo_9[];
 
-/* full frame for tempo_none.xbm */
+/* key diff frame for tempo_none.xbm */
 extern const uint8_t gfx_tempo_none[];
 
 
@@ -20,6 +20,41 @@
 #include "gfx.h"
 #include "lcd.h"
 #include "menu.h"
+#include "pattern.h"
+#include "playback.h"
+
+/* metronome dot states */
+#define METRONOME_BIG   0
+#define METRONOME_SMALL 1
+#define METRONOME_CLEAR 2
+#define METRONOME_NONE  0xff
+
+/*
+ * Last rendered state of each widget.
+ *
+ * The gui_set_*() functions are called whenever a value may have changed,
+ * e.g. menu_init() sets them all. Only the widgets whose graphics actually
+ * differ from what's shown already are drawn again.
+ */
+/* menu, mode, chord key, and chord modifier graphics, NULL if none yet */
+static const unsigned char *shown_menu;
+static const unsigned char *shown_mode;
+static const unsigned char *shown_key;
+static const unsigned char *shown_key_mod;
+/* tempo digit graphics, 100's value first */
+static const unsigned char *shown_digits[3];
+/* tempo value the BCD digits represent */
+static uint8_t shown_tempo;
+/* tempo as three BCD digits, 100's value first */
+static uint8_t tempo_bcd[3];
+/* metre item, PLAYBACK_METRE_MAX if none yet */
+static uint8_t shown_metre = PLAYBACK_METRE_MAX;
+/* metronome dot, one of the METRONOME_* values */
+static uint8_t shown_metronome = METRONOME_NONE;
+/* key the chord list is shown in, PLAYBACK_KEY_MAX if none yet */
+static uint8_t shown_list_key = PLAYBACK_KEY_MAX;
+/* highlighted chords in the chord list, one bit per chord */
+static uint8_t shown_list_highlights;
 
 /* graphics data array for menus */
 static const unsigned char *menus[] = {
@@ -43,15 +78,6 @@ static const unsigned char *tempo_digits[] = {
     gfx_tempo_9,
 };
 
-/* graphics data array for modes */
-static const unsigned char *modes[] = {
-    gfx_mode_chord,
-    gfx_mode_chord_arp,
-    gfx_mode_chord_arp_oct,
-    gfx_mode_arp,
-    gfx_mode_arp_oct
-};
-
 /* graphics data array for key chords and modifiers */
 static const unsigned char *chords[][2] = {
     {gfx_key_c, gfx_key_none},
@@ -75,7 +101,10 @@ static const unsigned char *chords[][2] = {
 void
 gui_set_menu(menu_item_t item)
 {
-    lcd_set_menu(menus[item]);
+    if (shown_menu != menus[item]) {
+        shown_menu = menus[item];
+        lcd_set_menu(shown_menu);
+    }
 }
 
 /**
@@ -85,24 +114,92 @@ gui_set_menu(menu_item_t item)
 void
 gui_set_playback_mode(playback_mode_item_t item)
 {
-    lcd_set_mode(modes[item]);
+    const unsigned char *mode = pattern_get_gfx(item);
+
+    if (shown_mode != mode) {
+        shown_mode = mode;
+        lcd_set_mode(mode);
+    }
 }
 
 /**
  * Display the given playback key item graphic on the LCD.
+ * The chord list shows the chords in the new key, none of them
+ * highlighted.
+ *
  * @param Playback key item index in accordance with menu.h values
  */
 void
 gui_set_playback_key(playback_mode_item_t item)
 {
-    lcd_set_chord(chords[item]);
+    uint8_t chord_num;
+
+    if (shown_key != chords[item][0]) {
+        shown_key = chords[item][0];
+        lcd_set_key(shown_key);
+    }
+
+    if (shown_key_mod != chords[item][1]) {
+        shown_key_mod = chords[item][1];
+        lcd_set_key_mod(shown_key_mod);
+    }
+
+    if (shown_list_key != item) {
+        shown_list_key = item;
+        shown_list_highlights = 0;
+        for (chord_num = 0; chord_num < PLAYBACK_CHORD_MAX; chord_num++) {
+            lcd_set_list_chord(chord_num, 0);
+        }
+    }
+}
+
+/**
+ * Convert a tempo value to BCD digits.
+ * Moving one BPM up or down, as the menu buttons and their auto repeat do,
+ * only carries the digits along. Any other change is converted by
+ * subtracting hundreds and tens, there's no division involved either way.
+ *
+ * @param tempo New tempo
+ */
+static void
+tempo_to_bcd(uint8_t tempo)
+{
+    uint8_t digit;
+
+    if (tempo == (uint8_t) (shown_tempo + 1)) {
+        for (digit = 2; digit > 0 && tempo_bcd[digit] == 9; digit--) {
+            tempo_bcd[digit] = 0;
+        }
+        tempo_bcd[digit]++;
+
+    } else if (tempo == (uint8_t) (shown_tempo - 1)) {
+        for (digit = 2; digit > 0 && tempo_bcd[digit] == 0; digit--) {
+            tempo_bcd[digit] = 9;
+        }
+        tempo_bcd[digit]--;
+
+    } else {
+        shown_tempo = tempo;
+        for (digit = 0; tempo >= 100; digit++) {
+            tempo -= 100;
+        }
+        tempo_bcd[0] = digit;
+        for (digit = 0; tempo >= 10; digit++) {
+            tempo -= 10;
+        }
+        tempo_bcd[1] = digit;
+        tempo_bcd[2] = tempo;
+        return;
+    }
+
+    shown_tempo = tempo;
 }
 
 /**
  * Display the given tempo value on the LCD.
  * Takes tempo as 8 bit integer (>255bpm won't be supported anyway) and
- * splits it in three single digits. The digits' representing graphics
- * are then transferred to the LCD's tempo area.
+ * keeps it as three BCD digits. Only the digits whose graphics changed
+ * are transferred to the LCD's tempo area.
  *
  * @param tempo New tempo
  */
@@ -110,22 +207,22 @@ void
 gui_set_playback_tempo(uint8_t tempo)
 {
     const unsigned char *digit_graphics[3];
-    uint8_t digits[3];
-    uint8_t one, ten, hundred;
-
-    /* split integer to three digits */
-    one = tempo / 10;
-    digits[2] = tempo - (one * 10);
-    ten = one / 10;
-    digits[1] = one - (ten * 10);
-    hundred = ten / 10;
-    digits[0] = ten - (hundred * 10);
-
-    digit_graphics[0] = (digits[0] == 0) ? gfx_tempo_none : tempo_digits[digits[0]];
-    digit_graphics[1] = tempo_digits[digits[1]];
-    digit_graphics[2] = tempo_digits[digits[2]];
-
-    lcd_set_tempo(digit_graphics);
+    uint8_t digit;
+
+    if (tempo != shown_tempo) {
+        tempo_to_bcd(tempo);
+    }
+
+    digit_graphics[0] = (tempo_bcd[0] == 0) ? gfx_tempo_none : tempo_digits[tempo_bcd[0]];
+    digit_graphics[1] = tempo_digits[tempo_bcd[1]];
+    digit_graphics[2] = tempo_digits[tempo_bcd[2]];
+
+    for (digit = 0; digit < 3; digit++) {
+        if (shown_digits[digit] != digit_graphics[digit]) {
+            shown_digits[digit] = digit_graphics[digit];
+            lcd_set_tempo_digit(digit, digit_graphics[digit]);
+        }
+    }
 }
 
 /**
@@ -135,6 +232,11 @@ gui_set_playback_tempo(uint8_t tempo)
 void
 gui_set_playback_metre(playback_metre_item_t metre)
 {
+    if (shown_metre == metre) {
+        return;
+    }
+    shown_metre = metre;
+
     /* there may be a better way for this.. but not today. Hard coded it is */
     switch (metre) {
         case PLAYBACK_METRE_4_4:
@@ -151,3 +253,52 @@ gui_set_playback_metre(playback_metre_item_t metre)
     }
 }
 
+/**
+ * Display the metronome beat on the LCD.
+ * Only redraws the metronome if the beat shows a different dot than the
+ * previous one, see lcd_set_metronome() for the details.
+ *
+ * @param beat Beat number based on the playback cycle count
+ */
+void
+gui_set_metronome(uint8_t beat)
+{
+    uint8_t metronome;
+
+    if (beat == 0) {
+        metronome = METRONOME_BIG;
+    } else if ((beat & 0x01) == 0) {
+        metronome = METRONOME_SMALL;
+    } else {
+        metronome = METRONOME_CLEAR;
+    }
+
+    if (shown_metronome != metronome) {
+        shown_metronome = metronome;
+        lcd_set_metronome(beat);
+    }
+}
+
+/**
+ * Display a single chord in the chord list, highlighted or normal.
+ * Only redraws the chord if its highlighting changed.
+ *
+ * @param chord_num Chord number index of the currently selected key
+ * @param highlighted Set chord display highlighted (1) or normal (0)
+ */
+void
+gui_set_list_chord(uint8_t chord_num, uint8_t highlighted)
+{
+    uint8_t bit = (1 << chord_num);
+
+    if (!!(shown_list_highlights & bit) == !!highlighted) {
+        return;
+    }
+
+    if (highlighted) {
+        shown_list_highlights |= bit;
+    } else {
+        shown_list_highlights &= ~bit;
+    }
+    lcd_set_list_chord(chord_num, highlighted);
+}
@@ -36,6 +36,9 @@ void gui_set_playback_mode(playback_mode_item_t item);
 
 /**
  * Display the given playback key item graphic on the LCD.
+ * The chord list shows the chords in the new key, none of them
+ * highlighted.
+ *
  * @param Playback key item index in accordance with menu.h values
  */
 void gui_set_playback_key(playback_mode_item_t item);
@@ -43,8 +46,8 @@ void gui_set_playback_key(playback_mode_item_t item);
 /**
  * Display the given tempo value on the LCD.
  * Takes tempo as 8 bit integer (>255bpm won't be supported anyway) and
- * splits it in three single digits. The digits' representing graphics
- * are then transferred to the LCD's tempo area.
+ * keeps it as three BCD digits. Only the digits whose graphics changed
+ * are transferred to the LCD's tempo area.
  *
  * @param tempo New tempo
  */
@@ -56,4 +59,22 @@ void gui_set_playback_tempo(uint8_t);
  */
 void gui_set_playback_metre(playback_metre_item_t metre);
 
+/**
+ * Display the metronome beat on the LCD.
+ * Only redraws the metronome if the beat shows a different dot than the
+ * previous one, see lcd_set_metronome() for the details.
+ *
+ * @param beat Beat number based on the playback cycle count
+ */
+void gui_set_metronome(uint8_t beat);
+
+/**
+ * Display a single chord in the chord list, highlighted or normal.
+ * Only redraws the chord if its highlighting changed.
+ *
+ * @param chord_num Chord number index of the currently selected key
+ * @param highlighted Set chord display highlighted (1) or normal (0)
+ */
+void gui_set_list_chord(uint8_t chord_num, uint8_t highlighted);
+
 #endif
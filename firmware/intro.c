@@ -6,71 +6,43 @@
 #include <stdint.h>
 #include "intro.h"
 
-/* full frame for frame_01.xbm */
+/* rle frame for frame_01.xbm */
 const uint8_t intro_frame_01[] PROGMEM = {
-        0xfe, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 
-        0x02, 0xfe, 0xfe, 0xfe, 0xfe, 0xfe, 0x02, 0x02, 
-        0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0xfe, 0xfe, 
-        0xfe, 0xfe, 0xfe, 0x02, 0x02, 0x02, 0x02, 0x02, 
-        0x02, 0x02, 0x02, 0x02, 0xfe, 0x02, 0x02, 0x02, 
-        0x02, 0x02, 0x02, 0x02, 0x02, 0xfe, 0xfe, 0xfe, 
-        0xfe, 0xfe, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 
-        0x02, 0xfe, 0xfe, 0xfe, 0xfe, 0xfe, 0x02, 0x02, 
-        0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0xfe, 0xfe, 
-        0xfe, 0xfe, 0xfe, 0x02, 0x02, 0x02, 0x02, 0x02, 
-        0x02, 0x02, 0x02, 0xfe, 0xff, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 
-        0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 
-        0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 
-        0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 
-        0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 
-        0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 
-        0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 
-        0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0x00, 0xff, 0xff, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x03, 0x03, 
-        0xff, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0x03, 0xff, 0x03, 0x03, 0x03, 0x00, 
-        0xf0, 0xf8, 0x0c, 0x04, 0x04, 0x0c, 0x08, 0x00, 
-        0xff, 0x00, 0xff, 0xff, 0x08, 0x04, 0x04, 0xfc, 
-        0xfc, 0xf3, 0x03, 0xff, 0x03, 0x43, 0xf0, 0xf8, 
-        0x0c, 0x04, 0x04, 0x0c, 0xf8, 0xf3, 0x03, 0xff, 
-        0x03, 0x03, 0x00, 0x00, 0xfc, 0xfc, 0x18, 0x0c, 
-        0x0c, 0x00, 0x03, 0xff, 0x03, 0x03, 0xfb, 0xf8, 
-        0x0c, 0x04, 0x04, 0xff, 0xff, 0xfe, 0x00, 0xff, 
-        0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00, 
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x03, 0x02, 
+        0x00, 0xfe, 0x86, 0x02, 0x83, 0xfe, 0x86, 0x02, 
+        0x83, 0xfe, 0x87, 0x02, 0x00, 0xfe, 0x86, 0x02, 
+        0x83, 0xfe, 0x85, 0x02, 0x83, 0xfe, 0x86, 0x02, 
+        0x83, 0xfe, 0x86, 0x02, 0x01, 0xfe, 0xff, 0x86, 
+        0x00, 0x83, 0xff, 0x86, 0x00, 0x83, 0xff, 0x87, 
+        0x00, 0x00, 0xff, 0x86, 0x00, 0x83, 0xff, 0x85, 
+        0x00, 0x83, 0xff, 0x86, 0x00, 0x83, 0xff, 0x86, 
+        0x00, 0x01, 0xff, 0xff, 0x86, 0x00, 0x83, 0xff, 
+        0x86, 0x00, 0x83, 0xff, 0x87, 0x00, 0x00, 0xff, 
+        0x86, 0x00, 0x83, 0xff, 0x85, 0x00, 0x83, 0xff, 
+        0x86, 0x00, 0x83, 0xff, 0x86, 0x00, 0x01, 0xff, 
+        0xff, 0x86, 0x00, 0x81, 0x03, 0x01, 0xff, 0x03, 
+        0x86, 0x00, 0x01, 0x03, 0xff, 0x81, 0x03, 0x39, 
+        0x00, 0xf0, 0xf8, 0x0c, 0x04, 0x04, 0x0c, 0x08, 
+        0x00, 0xff, 0x00, 0xff, 0xff, 0x08, 0x04, 0x04, 
+        0xfc, 0xfc, 0xf3, 0x03, 0xff, 0x03, 0x43, 0xf0, 
+        0xf8, 0x0c, 0x04, 0x04, 0x0c, 0xf8, 0xf3, 0x03, 
+        0xff, 0x03, 0x03, 0x00, 0x00, 0xfc, 0xfc, 0x18, 
+        0x0c, 0x0c, 0x00, 0x03, 0xff, 0x03, 0x03, 0xfb, 
+        0xf8, 0x0c, 0x04, 0x04, 0xff, 0xff, 0xfe, 0x00, 
+        0xff, 0xff, 0x89, 0x00, 0x00, 0xff, 0x88, 0x00, 
+        0x00, 0xff, 0x83, 0x00, 0x37, 0x01, 0x03, 0x02, 
         0x02, 0x03, 0x01, 0x00, 0xff, 0xf8, 0xfb, 0x3b, 
         0xe0, 0xc0, 0x00, 0x83, 0xc3, 0x71, 0xf8, 0xff, 
         0x00, 0x00, 0x01, 0x03, 0x03, 0xfa, 0xfa, 0x03, 
         0x01, 0x00, 0x00, 0xff, 0x00, 0xf8, 0xf8, 0x18, 
         0x1b, 0x1b, 0x18, 0x18, 0x30, 0xf0, 0xc0, 0xff, 
         0x00, 0x00, 0x01, 0x03, 0xfb, 0xfa, 0x02, 0x03, 
-        0x03, 0x01, 0x00, 0xff, 0x1f, 0x10, 0x10, 0x10, 
-        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 
-        0x1f, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 
-        0x10, 0x10, 0x10, 0x1f, 0x10, 0x10, 0x10, 0x10, 
-        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 
+        0x03, 0x01, 0x00, 0xff, 0x1f, 0x89, 0x10, 0x00, 
+        0x1f, 0x88, 0x10, 0x00, 0x1f, 0x8a, 0x10, 0x0b, 
         0x1f, 0x17, 0x17, 0x10, 0x10, 0x13, 0x17, 0x17, 
-        0x11, 0x10, 0x17, 0x1f, 0x10, 0x10, 0x10, 0x10, 
-        0x10, 0x17, 0x17, 0x10, 0x10, 0x10, 0x10, 0x1f, 
-        0x10, 0x17, 0x17, 0x16, 0x16, 0x16, 0x16, 0x16, 
-        0x13, 0x13, 0x11, 0x1f, 0x10, 0x10, 0x10, 0x10, 
-        0x17, 0x17, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1f, 
+        0x11, 0x10, 0x17, 0x1f, 0x83, 0x10, 0x01, 0x17, 
+        0x17, 0x82, 0x10, 0x03, 0x1f, 0x10, 0x17, 0x17, 
+        0x83, 0x16, 0x03, 0x13, 0x13, 0x11, 0x1f, 0x82, 
+        0x10, 0x01, 0x17, 0x17, 0x83, 0x10, 0x00, 0x1f, 
 };
 
 /* diff frame for frame_01.xbm -> frame_02.xbm */
@@ -192,7 +164,7 @@ const struct xbmlib_diff_frame intro_frame_11__frame_12 PROGMEM = {
 
 /* one-shot animation frame mapping */
 const struct xbmlib_frame intro_frames[] PROGMEM = {
-    {TYPE_FULL, &intro_frame_01},
+    {TYPE_RLE, &intro_frame_01},
     {TYPE_DIFF, &intro_frame_01__frame_02},
     {TYPE_DIFF, &intro_frame_02__frame_03},
     {TYPE_DIFF, &intro_frame_03__frame_04},
@@ -7,7 +7,7 @@
 #include <stdint.h>
 #include "xbmlib.h"
 
-/* full frame for frame_01.xbm */
+/* rle frame for frame_01.xbm */
 extern const uint8_t intro_frame_01[];
 
 /* diff frame for frame_01.xbm -> frame_02.xbm */
@@ -49,6 +49,19 @@
  * 6 Chord list     y6      x0-84   1*64 px
  * 7 Metre          y3-4    x45-49  2*5  px
  * 8 Metronome      y3-4    x34-39  2*6  px
+ *
+ * None of the lcd_set_*() functions talk to the LCD itself, they all draw
+ * into a RAM copy of the display memory instead. Each of the 6 rows (banks)
+ * keeps track of the columns that changed since the last lcd_flush() call,
+ * which then sends only those over SPI. Redrawing an area with the same
+ * graphics, such as the metronome on every beat, costs no SPI traffic at
+ * all that way.
+ *
+ * lcd_flush() doesn't wait for the whole transfer either, it sends at most
+ * LCD_FLUSH_BYTES of the changed runs per call and continues with the rest
+ * on the next call from the main loop. The metronome area is tracked on
+ * its own and gets sent ahead of any other changes, even interrupting a
+ * run that is already in progress.
  */
 #include <stdint.h>
 #include <string.h>
@@ -63,8 +76,18 @@
 #define LCD_START_LINE_ADDR (66-2)
 #define LCD_X_RES   84
 #define LCD_Y_RES   48
+#define LCD_BANKS   (LCD_Y_RES / 8)
 #define LCD_MEMORY_SIZE     ((LCD_X_RES * LCD_Y_RES) / 8)
 
+/* RAM copy of the LCD memory, all lcd_set_*() functions draw in here */
+static uint8_t framebuffer[LCD_MEMORY_SIZE];
+/* first changed column of each bank since the last flush, LCD_X_RES if none */
+static uint8_t dirty_start[LCD_BANKS];
+/* one past the last changed column of each bank since the last flush */
+static uint8_t dirty_end[LCD_BANKS];
+/* metronome area changed since the last flush */
+static uint8_t metronome_dirty;
+
 /* display arrangement for the menu area */
 #define MENU_X   0
 #define MENU_Y   0
@@ -121,6 +144,40 @@
 #define MET_H        1
 
 
+/* column run of a single bank to send in the background */
+struct lcd_run {
+    uint8_t bank;
+    uint8_t start;
+    uint8_t end;
+};
+
+/* max number of bytes a single lcd_flush() call sends */
+#define LCD_FLUSH_BYTES 32
+
+/* changed runs collected by lcd_flush() */
+static struct lcd_run bulk_runs[LCD_BANKS];
+/* number of runs in bulk_runs */
+static uint8_t bulk_count;
+/* run currently sent, all done once it reaches bulk_count */
+static uint8_t bulk_next;
+/* metronome bank runs left to send, bottom bank last */
+static uint8_t priority_pending;
+
+/* type of the run currently sent, RUN_NONE if no transfer is ongoing */
+static enum {
+    RUN_NONE,
+    RUN_BULK,
+    RUN_PRIORITY
+} xfer_run;
+/* bank, next column, and end column of the current run */
+static uint8_t xfer_bank;
+static uint8_t xfer_col;
+static uint8_t xfer_end;
+/* LCD address counter position, LCD_X_RES / LCD_BANKS if unknown */
+static uint8_t cursor_x;
+static uint8_t cursor_y;
+
+
 /**
  * Initialize the LCD.
  */
@@ -138,21 +195,208 @@ lcd_init(void)
 }
 
 /**
- * Clear the LCD by writing all zeros to it.
+ * Pick the next run to send.
+ * Wraps up the run that was sent so far, remembering where a bulk run got
+ * interrupted, and continues with the metronome runs if there are any, or
+ * the next bulk run otherwise.
+ *
+ * @return 1 if there is a run to send, 0 if all is sent
+ */
+static uint8_t
+transfer_load(void)
+{
+    if (xfer_run == RUN_PRIORITY) {
+        priority_pending--;
+    } else if (xfer_run == RUN_BULK) {
+        if (xfer_col < xfer_end) {
+            /* interrupted by the metronome, continue there later */
+            bulk_runs[bulk_next].start = xfer_col;
+        } else {
+            bulk_next++;
+        }
+    }
+
+    if (priority_pending) {
+        xfer_run  = RUN_PRIORITY;
+        xfer_bank = (priority_pending > 1) ? MET_TOP_Y : MET_BOT_Y;
+        xfer_col  = MET_X;
+        xfer_end  = MET_X + MET_W;
+        return 1;
+    }
+
+    if (bulk_next < bulk_count) {
+        xfer_run  = RUN_BULK;
+        xfer_bank = bulk_runs[bulk_next].bank;
+        xfer_col  = bulk_runs[bulk_next].start;
+        xfer_end  = bulk_runs[bulk_next].end;
+        return 1;
+    }
+
+    xfer_run = RUN_NONE;
+    return 0;
+}
+
+/**
+ * Send the next byte of the background transfer.
+ * Sends the X and Y address commands for each run, unless the LCD's
+ * address counter is there already, followed by the run's data from the
+ * framebuffer. Once all is sent, the LCD is deselected again.
+ *
+ * Must only be called once the previous byte is shifted out.
+ */
+static void
+transfer_next(void)
+{
+    uint8_t value;
+
+    if (xfer_col == xfer_end ||
+            (priority_pending && xfer_run == RUN_BULK))
+    {
+        if (!transfer_load()) {
+            spi_cs_high();
+            return;
+        }
+    }
+
+    if (cursor_x != xfer_col) {
+        cursor_x = xfer_col;
+        spi_put_command(0x80 | xfer_col);
+
+    } else if (cursor_y != xfer_bank) {
+        cursor_y = xfer_bank;
+        spi_put_command(0x40 | xfer_bank);
+
+    } else {
+        value = framebuffer[xfer_bank * LCD_X_RES + xfer_col];
+        /* address counter moves on to the next bank after the last column */
+        if (++xfer_col == LCD_X_RES) {
+            cursor_x = 0;
+            cursor_y++;
+        } else {
+            cursor_x = xfer_col;
+        }
+        spi_put_data(value);
+    }
+}
+
+/**
+ * Send the rest of the background transfer.
+ * Called before all blocking writes to the LCD, so they don't end up in
+ * the middle of a run.
+ */
+static void
+transfer_finish(void)
+{
+    while (xfer_run != RUN_NONE) {
+        spi_wait_ready();
+        transfer_next();
+    }
+}
+
+/**
+ * Send framebuffer changes since the last call to the LCD.
+ *
+ * Each bank's changed columns are sent as one run, unchanged columns in
+ * between included, as that's usually cheaper than addressing each change
+ * on its own. At most LCD_FLUSH_BYTES are sent per call, the next call
+ * continues where this one stopped, so the main loop is never held up for
+ * long. Changes made while the previous runs are still being sent are
+ * picked up once they're done. Metronome changes are sent ahead of
+ * everything else.
  */
 void
-lcd_clear(void)
+lcd_flush(void)
 {
-    uint16_t addr;
+    uint8_t bank;
+    uint8_t count = 0;
+    uint8_t sent = 0;
 
-    spi_send_command(0x80); // set X addr to 0x00
-    spi_send_command(0x40); // set Y addr to 0x00
+    if (metronome_dirty && !priority_pending) {
+        metronome_dirty = 0;
+        priority_pending = MET_BOT_Y - MET_TOP_Y + 1;
+    }
 
-    for (addr = 0; addr < LCD_MEMORY_SIZE; addr++) {
-        spi_send_data(0x00);
+    if (bulk_next == bulk_count) {
+        /* all previous runs are sent, fill in the next ones */
+        bulk_count = 0;
+        bulk_next = 0;
+        for (bank = 0; bank < LCD_BANKS; bank++) {
+            if (dirty_start[bank] < dirty_end[bank]) {
+                bulk_runs[count].bank  = bank;
+                bulk_runs[count].start = dirty_start[bank];
+                bulk_runs[count].end   = dirty_end[bank];
+                count++;
+
+                dirty_start[bank] = LCD_X_RES;
+                dirty_end[bank] = 0;
+            }
+        }
+        bulk_count = count;
+    }
+
+    if (xfer_run == RUN_NONE) {
+        if (!priority_pending && bulk_next == bulk_count) {
+            return;
+        }
+        /* blocking transfers may have moved the address counter anywhere */
+        cursor_x = LCD_X_RES;
+        cursor_y = LCD_BANKS;
+        xfer_col = 0;
+        xfer_end = 0;
+
+        spi_cs_low();
+        transfer_next();
+        sent++;
+    }
+
+    /*
+     * A byte takes only 32 CPU cycles to shift out, 16 with SPI double
+     * speed, so waiting for the previous one here is practically free.
+     */
+    while (xfer_run != RUN_NONE && sent++ < LCD_FLUSH_BYTES) {
+        spi_wait_ready();
+        transfer_next();
     }
 }
 
+/**
+ * Clear the LCD by writing all zeros to it.
+ * Clears the framebuffer along with it, dropping all pending changes.
+ * An ongoing background transfer is finished first.
+ */
+void
+lcd_clear(void)
+{
+    uint8_t bank;
+
+    transfer_finish();
+    spi_begin();
+    spi_write_command(0x80); // set X addr to 0x00
+    spi_write_command(0x40); // set Y addr to 0x00
+    spi_write_fill(0x00, LCD_MEMORY_SIZE);
+    spi_end();
+
+    memset(framebuffer, 0x00, LCD_MEMORY_SIZE);
+    for (bank = 0; bank < LCD_BANKS; bank++) {
+        dirty_start[bank] = LCD_X_RES;
+        dirty_end[bank] = 0;
+    }
+    metronome_dirty = 0;
+}
+
+/**
+ * Set the LCD to inverse or normal video mode.
+ * An ongoing background transfer is finished first.
+ *
+ * @param inverse 1 for inverse video mode, 0 for normal mode
+ */
+void
+lcd_set_inverse(uint8_t inverse)
+{
+    transfer_finish();
+    spi_send_command(inverse ? 0x0d : 0x0c);
+}
+
 /**
  * Display fullscreen image data on the LCD.
  * Note, data is expected to be stored in PROGMEM and contain the
@@ -163,14 +407,11 @@ lcd_clear(void)
 static void
 lcd_write_full_frame(const uint8_t *data)
 {
-    uint16_t addr;
-
-    spi_send_command(0x80); // set X addr to 0x00
-    spi_send_command(0x40); // set Y addr to 0x00
-
-    for (addr = 0; addr < LCD_MEMORY_SIZE; addr++) {
-        spi_send_data(pgm_read_byte(&data[addr]));
-    }
+    spi_begin();
+    spi_write_command(0x80); // set X addr to 0x00
+    spi_write_command(0x40); // set Y addr to 0x00
+    spi_write_data_pgm(data, LCD_MEMORY_SIZE);
+    spi_end();
 }
 
 /**
@@ -191,6 +432,7 @@ lcd_write_diff_frame(const struct xbmlib_diff_frame *frame)
     uint8_t last_addr = 0;
     uint8_t offset = 0;
 
+    spi_begin();
     for (diff_index = 0; diff_index < diffcnt; diff_index++) {
         diff.addr = pgm_read_word(&(frame->diffs[diff_index].addr));
         diff.data = pgm_read_byte(&(frame->diffs[diff_index].data));
@@ -205,10 +447,11 @@ lcd_write_diff_frame(const struct xbmlib_diff_frame *frame)
         y = full_addr / LCD_X_RES;
         x = full_addr - y * LCD_X_RES;
 
-        spi_send_command(0x80 | x); // set X addr to `x`
-        spi_send_command(0x40 | y); // set Y addr to `y`
-        spi_send_data(diff.data);
+        spi_write_command(0x80 | x); // set X addr to `x`
+        spi_write_command(0x40 | y); // set Y addr to `y`
+        spi_write_byte(diff.data);
     }
+    spi_end();
 }
 
 /**
@@ -231,8 +474,9 @@ lcd_write_key_diff_frame(const struct xbmlib_key_diff_frame *frame)
     uint8_t offset = 0;
     uint16_t current_addr = 0;
 
-    spi_send_command(0x80); // set X addr to 0x00
-    spi_send_command(0x40); // set Y addr to 0x00
+    spi_begin();
+    spi_write_command(0x80); // set X addr to 0x00
+    spi_write_command(0x40); // set Y addr to 0x00
 
     for (diff_index = 0; diff_index < diffcnt; diff_index++) {
         diff.addr = pgm_read_word(&(frame->diffs[diff_index].addr));
@@ -245,16 +489,46 @@ lcd_write_key_diff_frame(const struct xbmlib_key_diff_frame *frame)
         last_addr = diff.addr;
         full_addr = diff.addr + 256 * offset;
 
-        while (current_addr++ < full_addr) {
-            spi_send_data(base_value);
-        }
-
-        spi_send_data(diff.data);
+        spi_write_fill(base_value, full_addr - current_addr);
+        spi_write_byte(diff.data);
+        current_addr = full_addr + 1;
     }
 
-    while (current_addr++ < LCD_MEMORY_SIZE) {
-        spi_send_data(base_value);
+    spi_write_fill(base_value, LCD_MEMORY_SIZE - current_addr);
+    spi_end();
+}
+
+/**
+ * Display run-length encoded frame image on the LCD.
+ * Decodes the given frame data block by block straight to the LCD, runs
+ * are written as repeated byte, literal blocks as-is from PROGMEM.
+ *
+ * @param data run-length encoded PROGMEM frame data to display
+ */
+static void
+lcd_write_rle_frame(const uint8_t *data)
+{
+    uint16_t current_addr = 0;
+    uint8_t control;
+    uint8_t count;
+
+    spi_begin();
+    spi_write_command(0x80); // set X addr to 0x00
+    spi_write_command(0x40); // set Y addr to 0x00
+
+    while (current_addr < LCD_MEMORY_SIZE) {
+        control = pgm_read_byte(data++);
+        if (control & 0x80) {
+            count = (control & 0x7f) + 2;
+            spi_write_fill(pgm_read_byte(data++), count);
+        } else {
+            count = control + 1;
+            spi_write_data_pgm(data, count);
+            data += count;
+        }
+        current_addr += count;
     }
+    spi_end();
 }
 
 /**
@@ -271,6 +545,7 @@ lcd_write_frame(const struct xbmlib_frame *frame)
     uint8_t frame_type = pgm_read_byte(&frame->type);
     void *ptr = pgm_read_ptr(&frame->data);
 
+    transfer_finish();
     switch (frame_type) {
         case TYPE_FULL:
             lcd_write_full_frame(ptr);
@@ -281,21 +556,135 @@ lcd_write_frame(const struct xbmlib_frame *frame)
         case TYPE_KEY_DIFF:
             lcd_write_key_diff_frame(ptr);
             break;
+        case TYPE_RLE:
+            lcd_write_rle_frame(ptr);
+            break;
     }
 }
 
 typedef enum {
     MEMTYPE_RAM,
-    MEMTYPE_PROGMEM
+    MEMTYPE_PROGMEM,
+    MEMTYPE_GFX
 } memtype_t;
 
+/*
+ * Decoder state for graphics generated by xbmtool.sh as compressed
+ * graphics set, i.e. PROGMEM byte arrays with the xbmlib frame type as
+ * first byte, followed by the full, key diff, or run-length encoded data.
+ */
+struct gfx_decoder {
+    /* frame type */
+    uint8_t type;
+    /* next PROGMEM byte to read */
+    const uint8_t *data;
+    /* bytes left in the current run-length block, or diffs left */
+    uint8_t count;
+    /* current run-length block is a run of value */
+    uint8_t run;
+    /* repeated value of a run, or the key diff base value */
+    uint8_t value;
+    /* last diff address byte, and overflow offset added to it */
+    uint8_t last_addr;
+    uint16_t offset;
+    /* position of the next decoded byte, and of the next diff */
+    uint16_t pos;
+    uint16_t diff_pos;
+};
+
+/**
+ * Read the position of the next diff of a key diff graphic.
+ * @param dec Decoder state
+ */
+static void
+gfx_decoder_next_diff(struct gfx_decoder *dec)
+{
+    uint8_t addr = pgm_read_byte(dec->data++);
+
+    if (dec->last_addr > addr) {
+        dec->offset += 256;
+    }
+    dec->last_addr = addr;
+    dec->diff_pos = dec->offset + addr;
+}
+
+/**
+ * Set up the decoder for the given compressed graphic.
+ *
+ * @param dec Decoder state
+ * @param data Graphic data with frame type as first byte
+ */
+static void
+gfx_decoder_init(struct gfx_decoder *dec, const uint8_t *data)
+{
+    memset(dec, 0, sizeof(struct gfx_decoder));
+    dec->type = pgm_read_byte(data++);
+    dec->data = data;
+
+    if (dec->type == TYPE_KEY_DIFF) {
+        dec->value = pgm_read_byte(dec->data++);
+        dec->count = pgm_read_byte(dec->data++);
+        if (dec->count) {
+            gfx_decoder_next_diff(dec);
+        }
+    }
+}
+
+/**
+ * Decode the next byte of a compressed graphic.
+ *
+ * @param dec Decoder state
+ * @return Next graphic data byte
+ */
+static uint8_t
+gfx_decoder_next(struct gfx_decoder *dec)
+{
+    uint8_t control;
+    uint8_t value;
+
+    switch (dec->type) {
+        case TYPE_RLE:
+            if (dec->count == 0) {
+                control = pgm_read_byte(dec->data++);
+                dec->run = control & 0x80;
+                if (dec->run) {
+                    dec->count = (control & 0x7f) + 2;
+                    dec->value = pgm_read_byte(dec->data++);
+                } else {
+                    dec->count = control + 1;
+                }
+            }
+            dec->count--;
+            return (dec->run) ? dec->value : pgm_read_byte(dec->data++);
+
+        case TYPE_KEY_DIFF:
+            value = dec->value;
+            if (dec->count && dec->pos == dec->diff_pos) {
+                value = pgm_read_byte(dec->data++);
+                if (--dec->count) {
+                    gfx_decoder_next_diff(dec);
+                }
+            }
+            dec->pos++;
+            return value;
+
+        default:
+            return pgm_read_byte(dec->data++);
+    }
+}
+
 /**
  * Generic function to display data in a specified area on the LCD.
  * The displayed data can reside either in RAM or PROGMEM and is treated
- * like either one according to the given memtype paramter.
+ * like either one according to the given memtype paramter. Compressed
+ * graphics from PROGMEM are decoded byte by byte on the way.
+ *
+ * The data is written to the framebuffer, and only the columns that
+ * actually differ from it are marked to be sent on the next lcd_flush().
  *
  * @param data Graphic data to display
- * @param memtype Memory type to read the data from, RAM or PROGMEM
+ * @param memtype Memory type to read the data from, RAM, PROGMEM, or
+ *                compressed PROGMEM graphic
  * @param x Column start position on display (0 ... LCD_X_RES)
  * @param y Row start position on display (0 ... (LCD_Y_RES / 8))
  * @param w Data width, i.e. number of columns to display
@@ -307,16 +696,37 @@ lcd_set(const unsigned char *data, memtype_t memtype,
 {
     uint8_t row, col;
     uint8_t cnt = 0;
+    uint8_t bank;
+    uint8_t value;
+    uint8_t *fb;
+    struct gfx_decoder dec;
+
+    if (memtype == MEMTYPE_GFX) {
+        gfx_decoder_init(&dec, data);
+    }
 
     for (row = 0; row < h; row++) {
-        spi_send_command(0x80 | x);
-        spi_send_command(0x40 | (y + row));
-        for (col = 0; col < w; col++) {
-            if (memtype == MEMTYPE_PROGMEM) {
-                spi_send_data(pgm_read_byte(&(data[cnt++])));
+        bank = y + row;
+        fb = &framebuffer[bank * LCD_X_RES + x];
+        for (col = x; col < x + w; col++) {
+            if (memtype == MEMTYPE_GFX) {
+                value = gfx_decoder_next(&dec);
+            } else if (memtype == MEMTYPE_PROGMEM) {
+                value = pgm_read_byte(&(data[cnt++]));
             } else {
-                spi_send_data(data[cnt++]);
+                value = data[cnt++];
+            }
+
+            if (*fb != value) {
+                *fb = value;
+                if (col < dirty_start[bank]) {
+                    dirty_start[bank] = col;
+                }
+                if (col >= dirty_end[bank]) {
+                    dirty_end[bank] = col + 1;
+                }
             }
+            fb++;
         }
     }
 }
@@ -324,6 +734,7 @@ lcd_set(const unsigned char *data, memtype_t memtype,
 /* shortcuts for lcd_set */
 #define lcd_set_pgm(d, x, y, w, h) lcd_set(d, MEMTYPE_PROGMEM, x, y, w, h)
 #define lcd_set_mem(d, x, y, w, h) lcd_set(d, MEMTYPE_RAM, x, y, w, h)
+#define lcd_set_gfx(d, x, y, w, h) lcd_set(d, MEMTYPE_GFX, x, y, w, h)
 
 
 /**
@@ -334,7 +745,7 @@ lcd_set(const unsigned char *data, memtype_t memtype,
 void
 lcd_set_menu(const unsigned char *menu)
 {
-    lcd_set_pgm(menu, MENU_X, MENU_Y, MENU_W, MENU_H);
+    lcd_set_gfx(menu, MENU_X, MENU_Y, MENU_W, MENU_H);
 }
 
 /**
@@ -342,10 +753,10 @@ lcd_set_menu(const unsigned char *menu)
  *
  * @param key Key graphic data to display
  */
-static void
+void
 lcd_set_key(const unsigned char *key)
 {
-    lcd_set_pgm(key, KEY_X, KEY_Y, KEY_W, KEY_H);
+    lcd_set_gfx(key, KEY_X, KEY_Y, KEY_W, KEY_H);
 }
 
 /**
@@ -353,45 +764,30 @@ lcd_set_key(const unsigned char *key)
  *
  * @param modifier Modifier graphic data to display
  */
-static void
+void
 lcd_set_key_mod(const unsigned char *modifier)
 {
-    lcd_set_pgm(modifier, KEYMOD_X, KEYMOD_Y, KEYMOD_W, KEYMOD_H);
+    lcd_set_gfx(modifier, KEYMOD_X, KEYMOD_Y, KEYMOD_W, KEYMOD_H);
 }
 
-/**
- * Write the full chord area to the LCD internal memory.
- * This writes both, the chord key and the chord modifier.
- *
- * @param chords Array of two graphics for the chord key (index 0) and the
- *               chord modifier (index 1)
- */
-void
-lcd_set_chord(const unsigned char *chord[2])
-{
-    uint8_t i;
-
-    lcd_set_key(chord[0]);
-    lcd_set_key_mod(chord[1]);
-
-    for (i = 0; i < 4; i++) {
-        lcd_set_list_chord(i, 0);
-    }
-}
+/* Tempo digit position offsets. */
+static uint8_t tempo_digit_offsets[] = {
+    TEMPO_DIGIT1_X,
+    TEMPO_DIGIT2_X,
+    TEMPO_DIGIT3_X
+};
 
 /**
- * Display the tempo on the LCD.
- * The tempo is displayed as three digits, each digit is written separetely.
+ * Display a single tempo digit on the LCD.
  *
- * @param digits Array of three graphics, each containing the digit to display
- *               with index 0 holding the 100's value.
+ * @param digit_num Digit position, 0 for the 100's value
+ * @param digit Digit graphic data to display
  */
 void
-lcd_set_tempo(const unsigned char *digits[3])
+lcd_set_tempo_digit(uint8_t digit_num, const unsigned char *digit)
 {
-    lcd_set_pgm(digits[0], TEMPO_DIGIT1_X, TEMPO_Y, TEMPO_W, TEMPO_H);
-    lcd_set_pgm(digits[1], TEMPO_DIGIT2_X, TEMPO_Y, TEMPO_W, TEMPO_H);
-    lcd_set_pgm(digits[2], TEMPO_DIGIT3_X, TEMPO_Y, TEMPO_W, TEMPO_H);
+    lcd_set_gfx(digit, tempo_digit_offsets[digit_num],
+            TEMPO_Y, TEMPO_W, TEMPO_H);
 }
 
 /**
@@ -402,7 +798,7 @@ lcd_set_tempo(const unsigned char *digits[3])
 void
 lcd_set_mode(const unsigned char *mode)
 {
-    lcd_set_pgm(mode, MODE_X, MODE_Y, MODE_W, MODE_H);
+    lcd_set_gfx(mode, MODE_X, MODE_Y, MODE_W, MODE_H);
 }
 
 
@@ -514,6 +910,30 @@ static const uint8_t met_big[]   PROGMEM = {0x18, 0x3c, 0x7e, 0x7e, 0x3c, 0x18};
 static const uint8_t met_small[] PROGMEM = {0x00, 0x18, 0x3c, 0x3c, 0x18, 0x00};
 static const uint8_t met_clear[] PROGMEM = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 
+/**
+ * Display one half of the metronome area on the LCD.
+ * Works like lcd_set(), but marks the metronome area as changed instead
+ * of the bank, so lcd_flush() sends it ahead of all other changes.
+ *
+ * @param data Metronome graphic data to display
+ * @param y Row position on display, MET_TOP_Y or MET_BOT_Y
+ */
+static void
+lcd_set_met(const uint8_t *data, uint8_t y)
+{
+    uint8_t *fb = &framebuffer[y * LCD_X_RES + MET_X];
+    uint8_t value;
+    uint8_t col;
+
+    for (col = 0; col < MET_W; col++) {
+        value = pgm_read_byte(&(data[col]));
+        if (fb[col] != value) {
+            fb[col] = value;
+            metronome_dirty = 1;
+        }
+    }
+}
+
 /**
  * Display the metronome beat.
  *
@@ -532,16 +952,16 @@ void
 lcd_set_metronome(uint8_t beat)
 {
     if (beat == 0) {
-        lcd_set_pgm(met_big,   MET_X, MET_TOP_Y, MET_W, MET_H);
-        lcd_set_pgm(met_clear, MET_X, MET_BOT_Y, MET_W, MET_H);
+        lcd_set_met(met_big,   MET_TOP_Y);
+        lcd_set_met(met_clear, MET_BOT_Y);
 
     } else if ((beat & 0x01) == 0) {
-        lcd_set_pgm(met_clear, MET_X, MET_TOP_Y, MET_W, MET_H);
-        lcd_set_pgm(met_small, MET_X, MET_BOT_Y, MET_W, MET_H);
+        lcd_set_met(met_clear, MET_TOP_Y);
+        lcd_set_met(met_small, MET_BOT_Y);
 
     } else {
-        lcd_set_pgm(met_clear, MET_X, MET_TOP_Y, MET_W, MET_H);
-        lcd_set_pgm(met_clear, MET_X, MET_BOT_Y, MET_W, MET_H);
+        lcd_set_met(met_clear, MET_TOP_Y);
+        lcd_set_met(met_clear, MET_BOT_Y);
     }
 }
 
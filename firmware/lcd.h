@@ -56,9 +56,32 @@ void lcd_init(void);
 
 /**
  * Clear the LCD by writing all zeros to it.
+ * Clears the framebuffer along with it, dropping all pending changes.
+ * An ongoing background transfer is finished first.
  */
 void lcd_clear(void);
 
+/**
+ * Send framebuffer changes since the last call to the LCD.
+ *
+ * Each bank's changed columns are sent as one run, unchanged columns in
+ * between included, as that's usually cheaper than addressing each change
+ * on its own. At most LCD_FLUSH_BYTES are sent per call, the next call
+ * continues where this one stopped, so the main loop is never held up for
+ * long. Changes made while the previous runs are still being sent are
+ * picked up once they're done. Metronome changes are sent ahead of
+ * everything else.
+ */
+void lcd_flush(void);
+
+/**
+ * Set the LCD to inverse or normal video mode.
+ * An ongoing background transfer is finished first.
+ *
+ * @param inverse 1 for inverse video mode, 0 for normal mode
+ */
+void lcd_set_inverse(uint8_t inverse);
+
 /**
  * Display the given xbmlib frame on the display.
  * Wrapper function for all nokia_lcd_write_*_frame() functions, taking
@@ -76,22 +99,25 @@ void lcd_write_frame(const struct xbmlib_frame *frame);
 void lcd_set_menu(const unsigned char *menu);
 
 /**
- * Write the full chord area to the LCD internal memory.
- * This writes both, the chord key and the chord modifier.
- *
- * @param chords Array of two graphics for the chord key (index 0) and the
- *               chord modifier (index 1)
+ * Write the chord key area to the LCD internal memory.
+ * @param key Key graphics to be written to internal memory
+ */
+void lcd_set_key(const unsigned char *key);
+
+/**
+ * Write the chord modifier area to the LCD internal memory.
+ * @param modifier Modifier graphics to be written to internal memory
  */
-void lcd_set_chord(const unsigned char *chord[2]);
+void lcd_set_key_mod(const unsigned char *modifier);
 
 /**
- * Write the tempo area to the LCD internal memory.
+ * Write a single digit of the tempo area to the LCD internal memory.
  * The tempo is displayed as three digits, each digit is written separetely.
  *
- * @param digits Array of three graphics, each containing the digit to display
- *               with index 0 holding the 100's value.
+ * @param digit_num Digit position, 0 for the 100's value
+ * @param digit Digit graphics to be written to internal memory
  */
-void lcd_set_tempo(const unsigned char *digits[3]);
+void lcd_set_tempo_digit(uint8_t digit_num, const unsigned char *digit);
 
 /**
  * Write the mode area to the LCD internal memory.
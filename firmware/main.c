@@ -61,9 +61,11 @@
 #include <util/delay.h>
 #include "buttons.h"
 #include "cli.h"
+#include "clock.h"
 #include "eeprom.h"
 #include "lcd.h"
 #include "menu.h"
+#include "pattern.h"
 #include "xbmlib.h"
 #include "intro.h"
 #include "gui.h"
@@ -71,6 +73,7 @@
 #include "spi.h"
 #include "timer.h"
 #include "uart.h"
+#include "usb.h"
 #include "usbdrv/usbdrv.h"
 
 /** number of steps to increase the PWM timer value during the intro */
@@ -119,6 +122,12 @@ main(void) {
 
     /* set up LCD backlight timer and show the first intro animation frame */
     timer0_init_pwm();
+    /* set up system tick timer */
+    timer2_init_systick();
+    /* set up USB descriptors according to the EEPROM settings */
+    usb_init();
+    /* set up MIDI clock handling according to the EEPROM settings */
+    clock_init();
 
     sei();
 
@@ -170,15 +179,20 @@ main(void) {
 
     /* clear the display and show the menu */
     lcd_clear();
+    pattern_init();
     menu_init();
+    playback_init();
 
     /* let the magic begin */
     while (1) {
         usbPoll();
+        usb_midi_poll();
         button_input_loop();
         playback_poll();
-        menu_poll();
+        clock_poll();
+        timer_poll();
         cli_poll();
+        lcd_flush();
     }
 }
 
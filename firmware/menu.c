@@ -22,18 +22,25 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <avr/eeprom.h>
+#include <avr/pgmspace.h>
 #include <util/delay.h>
 #include "eeprom.h"
 #include "menu.h"
 #include "gui.h"
+#include "lcd.h"
+#include "pattern.h"
 #include "playback.h"
-#include "spi.h" // XXX temporary to inverse display on "select" long press
-#include "timer.h"
+#include "uart.h"
+
+static const char tempo_string[] PROGMEM = "Tempo: ";
+static const char tempo_bpm_string[] PROGMEM = " BPM\r\n";
 
 /* currently selected menu item */
 static menu_item_t menu_current;
 /* currently selected tempo */
 static playback_tempo_item_t playback_tempo_current;
+/* currently selected tempo fine adjustment in 0.1 BPM */
+static uint8_t playback_tempo_tenth_current;
 /* currently selected mode */
 static playback_mode_item_t playback_mode_current;
 /* currently selected chord */
@@ -41,10 +48,6 @@ static playback_key_item_t playback_key_current;
 /* currently selected metre */
 static playback_metre_item_t playback_metre_current;
 
-#define DELAY_LONG_PRESS    0x44a8 /* 1.5 seconds */
-#define DELAY_CYCLE_SLOW    0x16e2 /* 0.5 seconds */
-#define DELAY_CYCLE_FAST    0x0492 /* 0.1 seconds */
-
 /**
  * Select next menu item and update the LCD.
  * If the last menu item is already selected, it cycles back to the first one.
@@ -63,34 +66,54 @@ menu_select(void)
 
 /**
  * Select the next playback mode and update the LCD.
- * Cycles back to the first item after the last one.
+ * Cycles back to the first item after the last one, empty user pattern
+ * slots are skipped.
  */
 static void
 playback_mode_next(void)
 {
-    if (++playback_mode_current == PLAYBACK_MODE_MAX) {
-        playback_mode_current = 0;
-    }
-    
+    do {
+        if (++playback_mode_current == PLAYBACK_MODE_MAX) {
+            playback_mode_current = 0;
+        }
+    } while (!pattern_valid(playback_mode_current));
+
     gui_set_playback_mode(playback_mode_current);
 }
 
 /**
  * Select the previous playback mode and update the LCD.
- * Cycles back to the last item after the first one.
+ * Cycles back to the last item after the first one, empty user pattern
+ * slots are skipped.
  */
 static void
 playback_mode_prev(void)
 {
-    if (playback_mode_current == 0) {
-        playback_mode_current = PLAYBACK_MODE_MAX - 1;
-    } else {
-        playback_mode_current--;
-    }
+    do {
+        if (playback_mode_current == 0) {
+            playback_mode_current = PLAYBACK_MODE_MAX - 1;
+        } else {
+            playback_mode_current--;
+        }
+    } while (!pattern_valid(playback_mode_current));
 
     gui_set_playback_mode(playback_mode_current);
 }
 
+/**
+ * Make sure the currently selected playback mode is still available.
+ * If the selected mode is a user pattern that got deleted in the meantime,
+ * the first playback mode is selected instead and the LCD is updated.
+ */
+void
+menu_playback_mode_check(void)
+{
+    if (!pattern_valid(playback_mode_current)) {
+        playback_mode_current = PLAYBACK_MODE_CHORD;
+        gui_set_playback_mode(playback_mode_current);
+    }
+}
+
 /**
  * Select the next playback key and update the LCD.
  * Cycles back to the first item after the last one.
@@ -131,6 +154,9 @@ playback_tempo_up(void)
 {
     if (playback_tempo_current < PLAYBACK_TEMPO_MAX) {
         playback_tempo_current++;
+        if (playback_tempo_current == PLAYBACK_TEMPO_MAX) {
+            playback_tempo_tenth_current = 0;
+        }
         gui_set_playback_tempo(playback_tempo_current);
     }
 }
@@ -149,6 +175,53 @@ playback_tempo_down(void)
     }
 }
 
+/**
+ * Print the current playback tempo including its fine adjustment via UART.
+ */
+static void
+playback_tempo_print(void)
+{
+    uart_print_pgm(tempo_string);
+    uart_putint(playback_tempo_current, 1);
+    uart_putchar('.');
+    uart_putint(playback_tempo_tenth_current, 1);
+    uart_print_pgm(tempo_bpm_string);
+}
+
+/**
+ * Increase the playback tempo by 0.1 BPM and update the LCD.
+ * The tempo is capped at PLAYBACK_TEMPO_MAX.
+ */
+void
+menu_tempo_fine_up(void)
+{
+    if (playback_tempo_current < PLAYBACK_TEMPO_MAX) {
+        if (++playback_tempo_tenth_current > PLAYBACK_TEMPO_TENTH_MAX) {
+            playback_tempo_tenth_current = 0;
+            playback_tempo_current++;
+            gui_set_playback_tempo(playback_tempo_current);
+        }
+    }
+    playback_tempo_print();
+}
+
+/**
+ * Decrease the playback tempo by 0.1 BPM and update the LCD.
+ * The tempo is capped at PLAYBACK_TEMPO_MIN.
+ */
+void
+menu_tempo_fine_down(void)
+{
+    if (playback_tempo_tenth_current > 0) {
+        playback_tempo_tenth_current--;
+    } else if (playback_tempo_current > PLAYBACK_TEMPO_MIN) {
+        playback_tempo_tenth_current = PLAYBACK_TEMPO_TENTH_MAX;
+        playback_tempo_current--;
+        gui_set_playback_tempo(playback_tempo_current);
+    }
+    playback_tempo_print();
+}
+
 /**
  * Select the next playback metre and update the LCD.
  * Cycles back to the first item after the last one.
@@ -246,6 +319,7 @@ menu_init(void)
     playback_mode_current  = eeprom_read_byte(&eeprom_data.defaults.mode);
     playback_metre_current = eeprom_read_byte(&eeprom_data.defaults.metre);
     playback_tempo_current = eeprom_read_byte(&eeprom_data.defaults.tempo);
+    playback_tempo_tenth_current = eeprom_read_byte(&eeprom_data.defaults.tempo_tenth);
 
     /* Sanitize values and make sure they are valid */
     if (menu_current >= MENU_MAX) {
@@ -258,7 +332,9 @@ menu_init(void)
         eeprom_update_byte(&eeprom_data.defaults.key, playback_key_current);
     }
 
-    if (playback_mode_current >= PLAYBACK_MODE_MAX) {
+    if (playback_mode_current >= PLAYBACK_MODE_MAX ||
+            !pattern_valid(playback_mode_current))
+    {
         playback_mode_current = PLAYBACK_MODE_CHORD;
         eeprom_update_byte(&eeprom_data.defaults.mode, playback_mode_current);
     }
@@ -275,6 +351,13 @@ menu_init(void)
         eeprom_update_byte(&eeprom_data.defaults.tempo, playback_tempo_current);
     }
 
+    if (playback_tempo_tenth_current > PLAYBACK_TEMPO_TENTH_MAX ||
+            (playback_tempo_current == PLAYBACK_TEMPO_MAX && playback_tempo_tenth_current > 0))
+    {
+        playback_tempo_tenth_current = 0;
+        eeprom_update_byte(&eeprom_data.defaults.tempo_tenth, playback_tempo_tenth_current);
+    }
+
     gui_set_menu(menu_current);
     gui_set_playback_mode(playback_mode_current);
     gui_set_playback_key(playback_key_current);
@@ -313,6 +396,16 @@ menu_get_current_playback_tempo(void)
     return playback_tempo_current;
 }
 
+/**
+ * Get the currently selected playback tempo including its fine adjustment.
+ * @return Currently selected playback tempo in 0.1 BPM
+ */
+uint16_t
+menu_get_current_playback_tempo_tenths(void)
+{
+    return playback_tempo_current * 10 + playback_tempo_tenth_current;
+}
+
 /**
  * Get the currently selected playback metre.
  * @return Currently selected playback metre.
@@ -324,50 +417,6 @@ menu_get_current_playback_metre(void)
 }
 
 
-/* button press status */
-static uint8_t pressed;
-/* timer trigger status */
-static uint8_t menu_timer_triggered;
-
-/* menu handle callback function */
-typedef void (*menu_handle_callback_t)(void);
-
-/*
- * menu button handler structure
- *
- * The cycle callback is executed whenever timer1 triggers an interrupt
- * which is based on the init_delay and cont_delay values.
- *
- * On initial start, the start callback is executed, and timer1 is set to
- * the init_delay value, after which the cycle callback is executed, if
- * it's not NULL. If cont_delay_cycles is 0, that's the end to it; timer1
- * is stopped and it's basically as if the button was released.
- *
- * However, if cont_delay_cycles is >0, a cycle counter is increased every
- * time timer1 triggers an interrupt. Once the cycle counter value matches
- * the cont_delay_cycles value, timer1 is restarted with the cont_delay
- * value, and continues calling the cycle callback for all eternity (well,
- * or until the button is released).
- */
-typedef struct {
-    /* start callback, executed once on button press, skipped if NULL */
-    menu_handle_callback_t start;
-    /* cycle callback, executed during long button press, skipped if NULL */
-    menu_handle_callback_t cycle;
-    /* long button press initial delay value for timer1 */
-    uint16_t init_delay;
-    /* long button press continued delay value for timer1 */
-    uint16_t cont_delay;
-    /* number of cycles of switch from initial delay to cotinued delay */
-    uint8_t cont_delay_cycles;
-} menu_handler_t;
-
-/* cycle counter to match against menu handler's cont_delay_cycles value */
-static uint8_t cycle_counter;
-/* flag to check if cycle counter needs to be further increased or not */
-static uint8_t cycle_handled;
-
-
 /**
  * Save current setup as default.
  *
@@ -379,7 +428,9 @@ static uint8_t cycle_handled;
  * the "Select" menu button. Later on this will be replaced by a general
  * settings menu opening up.
  */
-static void save_defaults(void) {
+static void
+save_defaults(void)
+{
     /* go one step back so long press won't affect menu selection */
     if (menu_current == 0) {
         menu_current = MENU_MAX - 1;
@@ -389,7 +440,7 @@ static void save_defaults(void) {
     gui_set_menu(menu_current);
 
     /* set inverse video mode and wait a bit */
-    spi_send_command(0x0d);
+    lcd_set_inverse(1);
     _delay_ms(125);
     /* store default values to EEPROM and wait a bit */
     eeprom_update_byte(&eeprom_data.defaults.menu, menu_current);
@@ -397,60 +448,12 @@ static void save_defaults(void) {
     eeprom_update_byte(&eeprom_data.defaults.mode, playback_mode_current);
     eeprom_update_byte(&eeprom_data.defaults.metre, playback_metre_current);
     eeprom_update_byte(&eeprom_data.defaults.tempo, playback_tempo_current);
+    eeprom_update_byte(&eeprom_data.defaults.tempo_tenth, playback_tempo_tenth_current);
     _delay_ms(125);
     /* set normal video mode back */
-    spi_send_command(0x0c);
-}
-
-/* menu handler structure for "<" button */
-static menu_handler_t menu_handler_prev = {
-    .start = menu_button_prev,
-    .cycle = menu_button_prev,
-    .init_delay = DELAY_CYCLE_SLOW,
-    .cont_delay = DELAY_CYCLE_FAST,
-    .cont_delay_cycles = 3
-};
-
-/* menu handler structure for "Select" button */
-static menu_handler_t menu_handler_select =  {
-    .start = menu_button_select,
-    .cycle = save_defaults, // TODO add settings menu here later
-    .init_delay = DELAY_LONG_PRESS,
-    .cont_delay_cycles = 0
-};
-
-/* menu handler structure for ">" button */
-static menu_handler_t menu_handler_next = {
-    .start = menu_button_next,
-    .cycle = menu_button_next,
-    .init_delay = DELAY_CYCLE_SLOW,
-    .cont_delay = DELAY_CYCLE_FAST,
-    .cont_delay_cycles = 3
-};
-
-/* array for all the menu handler structures */
-static menu_handler_t *menu_handlers[] = {
-    &menu_handler_prev,
-    &menu_handler_select,
-    &menu_handler_next
-};
-
-/* pointer to the currently active menu handler structure */
-static menu_handler_t *current_handler;
-
-/**
- * Timer compare match interrupt callback.
- * This is called from the timer1 interrupt handler. So to keep it as
- * short as possible, only a flag is set here that is then checked and
- * further processed in the menu_poll() function.
- */
-static void
-menu_timer_callback(void)
-{
-    menu_timer_triggered = 1;
+    lcd_set_inverse(0);
 }
 
-
 /**
  * Menu button press callback function.
  * Called when one of the three menu buttons is pressed. The pressed menu
@@ -461,82 +464,56 @@ menu_timer_callback(void)
 void
 menu_button_press(void *arg)
 {
-    menu_button_t menu_button_index = *((menu_button_t *) arg);
-
-    if (!pressed) {
-        current_handler = menu_handlers[menu_button_index];
-
-        if (current_handler->start != NULL) {
-            current_handler->start();
-        }
-
-        if (!playback_ongoing()) {
-            /*
-             * don't do long press if playback is ongoing, i.e. any of the
-             * chord buttons is pressed. Playback has priority and the long
-             * press handling will take over timer1 and stop the playback.
-             *
-             * TODO make this some configuration setting later on
-             */
-            timer1_start(current_handler->init_delay, menu_timer_callback);
-            cycle_counter = 0;
-            cycle_handled = 0;
-        }
-
-        pressed = 1;
+    switch (*((menu_button_t *) arg)) {
+        case MENU_BUTTON_PREV:
+            menu_button_prev();
+            break;
+        case MENU_BUTTON_SELECT:
+            menu_button_select();
+            break;
+        case MENU_BUTTON_NEXT:
+            menu_button_next();
+            break;
+        default:
+            break;
     }
 }
 
 /**
- * Button release callback function.
- * Called when one of the three menu buttons is released. The released menu
- * button number is given in the arg parameter.
+ * Menu button repeat callback function.
+ * Called periodically while the "<" or ">" menu button is held down, so
+ * holding it keeps on changing the current menu item's value. The held
+ * menu button number is given in the arg parameter.
  *
- * @param arg Released button number, given as pointer menu_button_t
+ * @param arg Held button number, given as pointer to menu_button_t
  */
 void
-menu_button_release(void *arg __attribute__((unused)))
+menu_button_repeat(void *arg)
 {
-    pressed = 0;
-
-    if (!playback_ongoing()) {
-        /*
-         * also here, don't interfere with timer1 if playback is ongoing.
-         *
-         * TODO same as in menu_button_press, this could be a setting
-         */
-        timer1_stop();
+    switch (*((menu_button_t *) arg)) {
+        case MENU_BUTTON_PREV:
+            menu_button_prev();
+            break;
+        case MENU_BUTTON_NEXT:
+            menu_button_next();
+            break;
+        default:
+            break;
     }
 }
 
 /**
- * Menu button poll function.
+ * Menu button long press callback function.
+ * Called once the "Select" menu button is held down long enough, and
+ * stores the current setup as default. The held menu button number is
+ * given in the arg parameter.
  *
- * Called from the main loop to periodically check the menu button press
- * state, and call the button's cycle function for long press cases.
+ * @param arg Held button number, given as pointer to menu_button_t
  */
 void
-menu_poll(void)
+menu_button_long_press(void *arg)
 {
-    if (menu_timer_triggered) {
-        if (current_handler->cycle != NULL) {
-            current_handler->cycle();
-        }
-
-        if (cycle_handled) {
-            /* do nothing else */
-
-        } else if (current_handler->cont_delay_cycles == 0) {
-            /* one time shot, done with that */
-            timer1_stop();
-            cycle_handled = 1;
-
-        } else if (++cycle_counter == current_handler->cont_delay_cycles) {
-            /* next cycle step, speed it up and be done with it */
-            timer1_start(current_handler->cont_delay, menu_timer_callback);
-            cycle_handled = 1;
-        }
-
-        menu_timer_triggered = 0;
+    if (*((menu_button_t *) arg) == MENU_BUTTON_SELECT) {
+        save_defaults(); // TODO add settings menu here later
     }
 }
@@ -53,6 +53,9 @@ typedef enum {
     PLAYBACK_KEY_MAX
 } playback_key_item_t;
 
+/* number of user programmable playback modes */
+#define PLAYBACK_MODE_USER_MAX 8
+
 /* Playback mode list */
 typedef enum {
     PLAYBACK_MODE_CHORD,
@@ -60,7 +63,9 @@ typedef enum {
     PLAYBACK_MODE_CHORD_ARP_OCTAVE,
     PLAYBACK_MODE_ARP,
     PLAYBACK_MODE_ARP_OCTAVE,
-    PLAYBACK_MODE_MAX
+    /* first user pattern, also the number of built-in modes */
+    PLAYBACK_MODE_USER,
+    PLAYBACK_MODE_MAX = PLAYBACK_MODE_USER + PLAYBACK_MODE_USER_MAX
 } playback_mode_item_t;
 
 /* Playback metre list */
@@ -78,6 +83,9 @@ typedef enum {
     PLAYBACK_TEMPO_MAX = 240
 } playback_tempo_item_t;
 
+/* Playback tempo fine adjustment, tenths of BPM on top of the tempo value */
+#define PLAYBACK_TEMPO_TENTH_MAX 9
+
 /**
  * Initialize the GUI menu.
  * Set up all internal default values and call the GUI functions to draw the
@@ -97,12 +105,37 @@ playback_key_item_t menu_get_current_playback_key(void);
  */
 playback_mode_item_t menu_get_current_playback_mode(void);
 
+/**
+ * Make sure the currently selected playback mode is still available.
+ * If the selected mode is a user pattern that got deleted in the meantime,
+ * the first playback mode is selected instead and the LCD is updated.
+ */
+void menu_playback_mode_check(void);
+
 /**
  * Get the currently selected playback tempo.
  * @return Currently selected playback tempo.
  */
 uint8_t menu_get_current_playback_tempo(void);
 
+/**
+ * Get the currently selected playback tempo including its fine adjustment.
+ * @return Currently selected playback tempo in 0.1 BPM
+ */
+uint16_t menu_get_current_playback_tempo_tenths(void);
+
+/**
+ * Increase the playback tempo by 0.1 BPM and update the LCD.
+ * The tempo is capped at PLAYBACK_TEMPO_MAX.
+ */
+void menu_tempo_fine_up(void);
+
+/**
+ * Decrease the playback tempo by 0.1 BPM and update the LCD.
+ * The tempo is capped at PLAYBACK_TEMPO_MIN.
+ */
+void menu_tempo_fine_down(void);
+
 /**
  * Get the currently selected playback metre.
  * @return Currently selected playback metre.
@@ -135,20 +168,23 @@ void menu_button_select(void);
 void menu_button_press(void *arg);
 
 /**
- * Button release callback function.
- * Called when one of the three menu buttons is released. The released menu
- * button number is given in the arg parameter.
+ * Menu button repeat callback function.
+ * Called periodically while the "<" or ">" menu button is held down, so
+ * holding it keeps on changing the current menu item's value. The held
+ * menu button number is given in the arg parameter.
  *
- * @param arg Released button number, given as pointer menu_button_t
+ * @param arg Held button number, given as pointer to menu_button_t
  */
-void menu_button_release(void *arg);
+void menu_button_repeat(void *arg);
 
 /**
- * Menu button poll function.
+ * Menu button long press callback function.
+ * Called once the "Select" menu button is held down long enough, and
+ * stores the current setup as default. The held menu button number is
+ * given in the arg parameter.
  *
- * Called from the main loop to periodically check the menu button press
- * state, and call the button's cycle function for long press cases.
+ * @param arg Held button number, given as pointer to menu_button_t
  */
-void menu_poll(void);
+void menu_button_long_press(void *arg);
 
 #endif
@@ -0,0 +1,234 @@
+/*
+ * 4chord MIDI - Playback patterns
+ *
+ * Copyright (C) 2020 Sven Gregori <sven@craplab.fi>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/
+ *
+ *
+ * Every playback mode is described as a table of steps in program space,
+ * which is run by the pattern interpreter in playback.c. Each step lists
+ * which chord tones stop and which start playing on that 1/8 note.
+ *
+ * To add a new playback mode, add its entry to the playback_mode_item_t
+ * list in menu.h and its pattern in the same position to the list here.
+ *
+ * User patterns follow the built-in modes. They are stored in the EEPROM
+ * in a packed two bytes per step format, and kept in a RAM cache for the
+ * playback, see pattern_init().
+ */
+#include <stdint.h>
+#include <avr/eeprom.h>
+#include <avr/pgmspace.h>
+#include "eeprom.h"
+#include "gfx.h"
+#include "pattern.h"
+
+/* shorter pattern step notation */
+#define STEP(on, off) { (on), (off), PATTERN_VELOCITY }
+
+/* list of all built-in patterns, in order of the playback_mode_item_t list */
+static const pattern_t patterns[PLAYBACK_MODE_USER] PROGMEM = {
+    [PLAYBACK_MODE_CHORD] = {
+        .gfx = gfx_mode_chord,
+        .flags = PATTERN_FLAG_HOLD,
+        .length = 1,
+        .steps = {
+            STEP(PATTERN_ALL, 0),
+        },
+    },
+    [PLAYBACK_MODE_CHORD_ARP] = {
+        .gfx = gfx_mode_chord_arp,
+        .length = 8,
+        .steps = {
+            STEP(PATTERN_ALL,   0),
+            STEP(PATTERN_THIRD, 0),
+            STEP(PATTERN_FIFTH, 0),
+            STEP(PATTERN_THIRD, 0),
+            STEP(PATTERN_ROOT,  0),
+            STEP(PATTERN_THIRD, 0),
+            STEP(PATTERN_FIFTH, 0),
+            STEP(PATTERN_THIRD, 0),
+        },
+    },
+    [PLAYBACK_MODE_CHORD_ARP_OCTAVE] = {
+        .gfx = gfx_mode_chord_arp_oct,
+        .length = 8,
+        .steps = {
+            STEP(PATTERN_ALL,    0),
+            STEP(PATTERN_THIRD,  0),
+            STEP(PATTERN_FIFTH,  0),
+            STEP(PATTERN_OCTAVE, 0),
+            STEP(PATTERN_ROOT,   0),
+            STEP(PATTERN_THIRD,  0),
+            STEP(PATTERN_FIFTH,  0),
+            STEP(PATTERN_OCTAVE, 0),
+        },
+    },
+    [PLAYBACK_MODE_ARP] = {
+        .gfx = gfx_mode_arp,
+        .length = 4,
+        .steps = {
+            STEP(PATTERN_ROOT,  PATTERN_THIRD),
+            STEP(PATTERN_THIRD, PATTERN_ROOT),
+            STEP(PATTERN_FIFTH, PATTERN_THIRD),
+            STEP(PATTERN_THIRD, PATTERN_FIFTH),
+        },
+    },
+    [PLAYBACK_MODE_ARP_OCTAVE] = {
+        .gfx = gfx_mode_arp_oct,
+        .length = 4,
+        .steps = {
+            STEP(PATTERN_ROOT,   PATTERN_OCTAVE),
+            STEP(PATTERN_THIRD,  PATTERN_ROOT),
+            STEP(PATTERN_FIFTH,  PATTERN_THIRD),
+            STEP(PATTERN_OCTAVE, PATTERN_FIFTH),
+        },
+    },
+};
+
+
+/* number of steps of each user pattern, 0 if the slot is empty */
+static uint8_t user_lengths[PLAYBACK_MODE_USER_MAX];
+/* RAM cache of all user pattern steps */
+static pattern_packed_step_t user_steps[PLAYBACK_MODE_USER_MAX][PATTERN_STEPS_MAX];
+
+
+/**
+ * Initialize the playback patterns.
+ * Reads the user pattern directory and all user pattern steps from the
+ * EEPROM into a RAM cache, so the playback never has to access the EEPROM.
+ */
+void
+pattern_init(void)
+{
+    uint8_t slot;
+    uint8_t length;
+
+    for (slot = 0; slot < PLAYBACK_MODE_USER_MAX; slot++) {
+        length = eeprom_read_byte(&eeprom_data.user_patterns.directory[slot].length);
+        if (length > PATTERN_STEPS_MAX) {
+            /* erased or invalid, treat the slot as empty */
+            length = 0;
+        }
+        user_lengths[slot] = length;
+    }
+
+    eeprom_read_block(user_steps, eeprom_data.user_patterns.steps, sizeof(user_steps));
+}
+
+/**
+ * Check if a given playback mode is available.
+ * Built-in modes are always available, user patterns only if their slot
+ * isn't empty.
+ *
+ * @param mode Playback mode
+ * @return 1 if the mode can be played, 0 otherwise
+ */
+uint8_t
+pattern_valid(playback_mode_item_t mode)
+{
+    return pattern_get_length(mode) > 0;
+}
+
+/**
+ * Get the PATTERN_FLAG_* values of a given playback mode.
+ * @param mode Playback mode
+ * @return Pattern flags
+ */
+uint8_t
+pattern_get_flags(playback_mode_item_t mode)
+{
+    if (mode >= PLAYBACK_MODE_USER) {
+        return 0;
+    }
+    return pgm_read_byte(&patterns[mode].flags);
+}
+
+/**
+ * Get the number of steps of a given playback mode.
+ * @param mode Playback mode
+ * @return Number of pattern steps, 0 for an empty user pattern slot
+ */
+uint8_t
+pattern_get_length(playback_mode_item_t mode)
+{
+    if (mode >= PLAYBACK_MODE_USER) {
+        return user_lengths[mode - PLAYBACK_MODE_USER];
+    }
+    return pgm_read_byte(&patterns[mode].length);
+}
+
+/**
+ * Get a single step of a given playback mode.
+ * @param mode Playback mode
+ * @param index Step index, must be less than the pattern length
+ * @param step Pointer to the step structure to fill
+ */
+void
+pattern_get_step(playback_mode_item_t mode, uint8_t index, pattern_step_t *step)
+{
+    pattern_packed_step_t *packed;
+
+    if (mode >= PLAYBACK_MODE_USER) {
+        packed = &user_steps[mode - PLAYBACK_MODE_USER][index];
+        step->on = packed->tones >> 4;
+        step->off = packed->tones & 0x0f;
+        step->velocity = packed->velocity;
+    } else {
+        memcpy_P(step, &patterns[mode].steps[index], sizeof(*step));
+    }
+}
+
+/**
+ * Get the graphic for a given playback mode.
+ * @param mode Playback mode
+ * @return Pointer to the mode graphic in program space
+ */
+const uint8_t *
+pattern_get_gfx(playback_mode_item_t mode)
+{
+    if (mode >= PLAYBACK_MODE_USER) {
+        return gfx_mode_user;
+    }
+    return pgm_read_ptr(&patterns[mode].gfx);
+}
+
+/**
+ * Store a user pattern.
+ * Writes the given steps to the EEPROM and updates the RAM cache. The
+ * directory entry is written last, so an interrupted write leaves at
+ * worst the old length with partially new steps behind.
+ *
+ * @param slot User pattern slot, 0..PLAYBACK_MODE_USER_MAX-1
+ * @param steps Pattern steps
+ * @param length Number of steps, 0 to delete the pattern
+ */
+void
+pattern_user_store(uint8_t slot, const pattern_step_t *steps, uint8_t length)
+{
+    pattern_packed_step_t *packed;
+    uint8_t i;
+
+    for (i = 0; i < length; i++) {
+        packed = &user_steps[slot][i];
+        packed->tones = (steps[i].on << 4) | (steps[i].off & 0x0f);
+        packed->velocity = steps[i].velocity;
+    }
+
+    eeprom_update_block(user_steps[slot], eeprom_data.user_patterns.steps[slot],
+            length * sizeof(pattern_packed_step_t));
+    eeprom_update_byte(&eeprom_data.user_patterns.directory[slot].length, length);
+
+    user_lengths[slot] = length;
+}
@@ -0,0 +1,148 @@
+/*
+ * 4chord MIDI - Playback patterns
+ *
+ * Copyright (C) 2020 Sven Gregori <sven@craplab.fi>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/
+ *
+ */
+#ifndef _PATTERN_H_
+#define _PATTERN_H_
+#include <stdint.h>
+#include "menu.h"
+
+/* chord tone bits used in the pattern step on and off masks */
+#define PATTERN_ROOT    (1 << 0)
+#define PATTERN_THIRD   (1 << 1)
+#define PATTERN_FIFTH   (1 << 2)
+#define PATTERN_OCTAVE  (1 << 3)
+#define PATTERN_ALL     (PATTERN_ROOT | PATTERN_THIRD | PATTERN_FIFTH | PATTERN_OCTAVE)
+
+/* max number of steps in a single pattern, one step per 1/8 note */
+#define PATTERN_STEPS_MAX 8
+
+/* default note on velocity */
+#define PATTERN_VELOCITY 0x7f
+
+/*
+ * Pattern flag: only play the first step on chord button press, and hold
+ * its notes until release. There are no cycle steps, so there's also no
+ * metronome and no gate length.
+ */
+#define PATTERN_FLAG_HOLD (1 << 0)
+
+/* single pattern step */
+typedef struct {
+    /* chord tones to start playing, PATTERN_* bit mask */
+    uint8_t on;
+    /* chord tones to stop playing before the new ones start */
+    uint8_t off;
+    /* note on velocity of the started chord tones */
+    uint8_t velocity;
+} pattern_step_t;
+
+/*
+ * playback pattern structure
+ *
+ * The step for each playback cycle is chosen by the beat count modulo the
+ * pattern length, so a 4 step pattern simply repeats twice in a 4/4 bar.
+ */
+typedef struct {
+    /* mode graphic shown on the LCD */
+    const uint8_t *gfx;
+    /* PATTERN_FLAG_* values */
+    uint8_t flags;
+    /* number of used steps, 1..PATTERN_STEPS_MAX */
+    uint8_t length;
+    /* pattern steps */
+    pattern_step_t steps[PATTERN_STEPS_MAX];
+} pattern_t;
+
+/*
+ * user pattern step as stored in the EEPROM
+ *
+ * The chord tones to start are stored in the upper nibble of the tones
+ * value, the ones to stop in the lower nibble.
+ */
+typedef struct {
+    uint8_t tones;
+    uint8_t velocity;
+} pattern_packed_step_t;
+
+/* user pattern directory entry as stored in the EEPROM */
+typedef struct {
+    /* number of used steps, 0 (or erased 0xff) if the slot is empty */
+    uint8_t length;
+    /* note length in percent */
+    uint8_t gate;
+} pattern_dir_entry_t;
+
+/**
+ * Initialize the playback patterns.
+ * Reads the user pattern directory and all user pattern steps from the
+ * EEPROM into a RAM cache, so the playback never has to access the EEPROM.
+ */
+void pattern_init(void);
+
+/**
+ * Check if a given playback mode is available.
+ * Built-in modes are always available, user patterns only if their slot
+ * isn't empty.
+ *
+ * @param mode Playback mode
+ * @return 1 if the mode can be played, 0 otherwise
+ */
+uint8_t pattern_valid(playback_mode_item_t mode);
+
+/**
+ * Get the PATTERN_FLAG_* values of a given playback mode.
+ * @param mode Playback mode
+ * @return Pattern flags
+ */
+uint8_t pattern_get_flags(playback_mode_item_t mode);
+
+/**
+ * Get the number of steps of a given playback mode.
+ * @param mode Playback mode
+ * @return Number of pattern steps, 0 for an empty user pattern slot
+ */
+uint8_t pattern_get_length(playback_mode_item_t mode);
+
+/**
+ * Get a single step of a given playback mode.
+ * @param mode Playback mode
+ * @param index Step index, must be less than the pattern length
+ * @param step Pointer to the step structure to fill
+ */
+void pattern_get_step(playback_mode_item_t mode, uint8_t index, pattern_step_t *step);
+
+/**
+ * Get the graphic for a given playback mode.
+ * @param mode Playback mode
+ * @return Pointer to the mode graphic in program space
+ */
+const uint8_t *pattern_get_gfx(playback_mode_item_t mode);
+
+/**
+ * Store a user pattern.
+ * Writes the given steps to the EEPROM and updates the RAM cache. The
+ * directory entry is written last, so an interrupted write leaves at
+ * worst the old length with partially new steps behind.
+ *
+ * @param slot User pattern slot, 0..PLAYBACK_MODE_USER_MAX-1
+ * @param steps Pattern steps
+ * @param length Number of steps, 0 to delete the pattern
+ */
+void pattern_user_store(uint8_t slot, const pattern_step_t *steps, uint8_t length);
+
+#endif
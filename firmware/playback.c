@@ -18,74 +18,158 @@
  */
 #include <stdio.h>
 #include <stdint.h>
+#include <string.h>
 #include <avr/pgmspace.h>
-#include "lcd.h"
+#include <avr/eeprom.h>
+#include <util/atomic.h>
+#include "buttons.h"
+#include "clock.h"
+#include "eeprom.h"
+#include "gui.h"
 #include "menu.h"
+#include "pattern.h"
 #include "playback.h"
+#include "ring.h"
 #include "timer.h"
+#include "uart.h"
 #include "usb.h"
+#include "voicings.h"
 
-/* root notes array for each chord (I, V, vi, IV) in all keys (C..B) */
-static const uint8_t root_notes[PLAYBACK_KEY_MAX][4] PROGMEM = {
-    {48, 43, 45, 41},   /* C3   G2  A2  F2  */
-    {49, 44, 46, 42},   /* C#3  G#2 Bb2 F#2 */
-    {50, 45, 47, 43},   /* D3   A2  B2  G2  */
-    {51, 46, 48, 44},   /* D#3  Bb2 C3  G#2 */
-    {52, 47, 49, 45},   /* E3   B2  C#3 A2  */
-    {53, 48, 50, 46},   /* F3   C3  D3  Bb2 */
-    {54, 49, 51, 47},   /* F#3  C#3 D#3 B2  */
-    {43, 50, 52, 48},   /* G2   D3  E3  C3  */
-    {44, 51, 53, 49},   /* G#2  D#3 F3  C#3 */
-    {45, 52, 54, 50},   /* A2   E3  F#3 D3  */
-    {46, 41, 43, 39},   /* Bb2  F2  G2  D#2 */
-    {47, 42, 44, 40}    /* B2   F#2 G#2 E2  */
-};
-
-/* list of offsets to the chord's major (I, V, IV) or minor (vi) third */
-static const uint8_t third_offset[] = {4, 4, 3, 4};
-
-/* offset to the chord's perfect fifth, same for all */
-static const uint8_t fifth_offset = 7;
-
-/* offset to the root octave */
-static const uint8_t octave_offset = 12;
-
-/* MIDI note on velocity */
+static const char gate_string[] PROGMEM = "Gate: ";
+static const char gate_percent_string[] PROGMEM = "%\r\n";
+static const char inversion_string[] PROGMEM = "Inversion: ";
+static const char seventh_string[] PROGMEM = "Seventh: ";
+static const char voice_leading_string[] PROGMEM = "Voice leading: ";
+static const char release_string[] PROGMEM = "Release: ";
+static const char release_note_off_string[] PROGMEM = "note off\r\n";
+static const char release_sustain_string[] PROGMEM = "sustain\r\n";
+static const char quantize_string[] PROGMEM = "Quantize: ";
+static const char quantize_beat_string[] PROGMEM = "beat\r\n";
+static const char quantize_bar_string[] PROGMEM = "bar\r\n";
+static const char on_string[] PROGMEM = "on\r\n";
+static const char off_string[] PROGMEM = "off\r\n";
+static const char step_queue_string[] PROGMEM = "Playback step queue: ";
+
+/* MIDI note off velocity */
 #define VELOCITY 0x7f
 
-/* button press status */
-static uint8_t pressed;
+/* number of MIDI notes */
+#define MIDI_NOTES 128
+
+/* chord buttons currently held, one bit per chord number */
+static uint8_t held;
+
+/* currently active playback mode, set in button press handler */
+static playback_mode_item_t pattern_mode;
+/* flags of the currently active pattern */
+static uint8_t pattern_flags = PATTERN_FLAG_HOLD;
+/* number of steps of the currently active pattern */
+static uint8_t pattern_length;
+
+/* beat counter within the bar, one count per 1/8 note */
+static volatile uint8_t count;
+
+/* chord tones currently playing, PATTERN_* bit mask */
+static uint8_t sounding;
+
+/* note length in percent of a cycle step for each playback mode */
+static uint8_t gates[PLAYBACK_MODE_MAX];
+
+/* beat counts of the clock steps that came without a prepared step */
+static uint8_t step_buf[PLAYBACK_STEP_QUEUE_SIZE];
+static ring_t step_ring = RING_INIT(step_buf);
+
+/* set when the next external clock step starts a new bar */
+static uint8_t playback_clock_restart;
+
+/* preparation state of the next pattern step */
+typedef enum {
+    /* nothing prepared for the next step */
+    STEP_IDLE,
+    /* next step is being prepared in the main loop */
+    STEP_RENDERING,
+    /* the clock step came while the step was still being prepared */
+    STEP_LATE,
+    /* next step is prepared and waits for the clock */
+    STEP_PREPARED,
+    /* prepared step was sent ahead of the clock for a chord change */
+    STEP_SENT,
+    /* step was sent on the clock, the metronome display is pending */
+    STEP_PLAYED
+} step_state_t;
+
+static volatile step_state_t step_state;
+/* beat count of the prepared step */
+static uint8_t step_beat;
+/* set while the next step's MIDI messages go to the stage queue */
+static uint8_t rendering;
+
+/* chord voicing of each chord button, valid while the button is held */
+static chord_t chords[PLAYBACK_CHORD_MAX];
+
+/* MIDI notes with a note on sent and no note off yet, one bit per note */
+static volatile uint8_t note_map[MIDI_NOTES / 8];
+/* number of held chords playing each MIDI note, one nibble per note */
+static uint8_t note_refs[MIDI_NOTES / 2];
+/* MIDI notes started within the current pattern step, one bit per note */
+static uint8_t step_triggered[MIDI_NOTES / 8];
+
+/* chord voicing setting, inversion and PLAYBACK_VOICING_* flags */
+static uint8_t voicing;
+
+#define NO_CHORD 0xff
+/* chord number of the last played chord for voice leading */
+static uint8_t last_chord_num = NO_CHORD;
+/* inversion of the last played chord for voice leading */
+static uint8_t last_inversion;
+
+/* released chord that keeps sounding for a legato change, NO_CHORD if none */
+static uint8_t legato_chord = NO_CHORD;
+
+/* chord release strategy */
+static playback_release_t release;
+/* set while the sustain pedal is down */
+static uint8_t sustain_down;
 
-extern playback_mode_t playback_mode_chord;
-extern playback_mode_t playback_mode_chord_arpeggio;
-extern playback_mode_t playback_mode_chord_arpeggio_octave;
-extern playback_mode_t playback_mode_arpeggio;
-extern playback_mode_t playback_mode_arpeggio_octave;
+/* chord change quantization */
+static playback_quantize_t quantize;
+/* chord buttons pressed while quantizing, waiting for the next boundary */
+static uint8_t latched;
+/* latched chord buttons that got released again before the boundary */
+static uint8_t latched_released;
+/* set if the latched chord changes are due as soon as the prepared step is sent */
+static uint8_t latched_step;
 
-/* array of available playback mode structures */
-static playback_mode_t *playback_modes[PLAYBACK_MODE_MAX] = {
-    &playback_mode_chord,
-    &playback_mode_chord_arpeggio,
-    &playback_mode_chord_arpeggio_octave,
-    &playback_mode_arpeggio,
-    &playback_mode_arpeggio_octave
-};
+/* scheduled note-off structure */
+typedef struct {
+    /* note to stop playing */
+    uint8_t note;
+    /* system ticks until the note-off is due, 0 if the slot is free */
+    uint16_t remaining;
+    /* set while the note-on waits in the stage queue, no countdown yet */
+    uint8_t staged;
+} note_off_t;
 
-/* pointer to currently active playback mode, set in button press handler */
-static playback_mode_t *playback_mode;
+/* scheduled note-offs, counted down in the system tick interrupt */
+static volatile note_off_t note_offs[PLAYBACK_NOTE_OFF_SLOTS];
 
-/* timer trigger status */
-static uint8_t playback_timer_triggered;
+/* note length in system ticks for all started notes, 0 to hold them */
+static uint16_t gate_ticks;
 
-/* currently selected chord to play */
-static chord_t chord;
+static void quantize_apply(uint8_t beat);
+static uint8_t quantize_boundary(uint8_t beat);
 
 
 /**
- * Construct the triad for a given chord number.
- * This sets up the global chord structure based on the current playback key
- * selected in the menu and the progression's chord number given by the button
- * press callback function.
+ * Set up the chord voicing for a given chord number.
+ * This looks up the chord button's voicing notes in the voicing tables
+ * based on the current playback key selected in the menu, the chord voicing
+ * setting, and the progression's chord number given by the button press
+ * callback function.
+ *
+ * With voice leading enabled, the selected inversion is only used for the
+ * first chord, every following chord uses the inversion closest to the
+ * previous one.
  *
  * @param chord_num Chord number given by the button press callback
  */
@@ -93,27 +177,28 @@ static void
 construct_chord(uint8_t chord_num)
 {
     uint8_t key = menu_get_current_playback_key();
+    uint8_t inversion = voicing & PLAYBACK_VOICING_INVERSION_MASK;
+    uint8_t lead = (voicing & PLAYBACK_VOICING_LEAD) && last_chord_num != NO_CHORD;
+    chord_t *chord = &chords[chord_num];
 
-    chord.root   = pgm_read_byte(&root_notes[key][chord_num]);
-    chord.third  = chord.root + third_offset[chord_num];
-    chord.fifth  = chord.root + fifth_offset;
-    chord.octave = chord.root + octave_offset;
-}
-
-/**
- * Set up the timer value based on the current playback tempo.
- * The actual playback will be based on 1/8 notes, but the interval is
- * based on 1/4 notes (at least for now, as there's only 4/4 metre),
- * so this will return half of the BPM interval.
- */
-static uint16_t
-playback_interval(void)
-{
-    uint8_t  tempo    = menu_get_current_playback_tempo();
-    uint32_t minute   = TICKS_PER_CYCLE * 60;
-    uint16_t interval = minute / tempo;
+    if (voicing & PLAYBACK_VOICING_SEVENTH) {
+        if (lead) {
+            inversion = pgm_read_byte(&voicings_lead_seventh[key][last_chord_num][last_inversion][chord_num]);
+        }
+        chord->length = VOICING_SEVENTH_NOTES;
+        memcpy_P(chord->notes, voicings_seventh[key][chord_num][inversion],
+                VOICING_SEVENTH_NOTES);
+    } else {
+        if (lead) {
+            inversion = pgm_read_byte(&voicings_lead_triad[key][last_chord_num][last_inversion][chord_num]);
+        }
+        chord->length = VOICING_TRIAD_NOTES;
+        memcpy_P(chord->notes, voicings_triad[key][chord_num][inversion],
+                VOICING_TRIAD_NOTES);
+    }
 
-    return interval >> 1;
+    last_chord_num = chord_num;
+    last_inversion = inversion;
 }
 
 /**
@@ -144,44 +229,1149 @@ playback_metre_count(void)
 }
 
 /**
- * Timer compare match interrupt callback.
- * Use the playback_poll() function to check its state.
+ * Release the prepared step's MIDI messages to the USB transmit queue.
+ * Starts the gate countdown of the step's notes at the same time. Called
+ * from the system tick interrupt, or with interrupts disabled.
+ */
+static void
+step_commit(void)
+{
+    uint8_t i;
+
+    usb_midi_stage_commit();
+    for (i = 0; i < PLAYBACK_NOTE_OFF_SLOTS; i++) {
+        note_offs[i].staged = 0;
+    }
+}
+
+/**
+ * Advance the playback by one cycle step based on the clock.
+ * In slave and master mode, the beat count keeps running even if no chord
+ * button is pressed, so a chord played at any time stays in phase with the
+ * clock. Called from the USB MIDI OUT handler in slave mode, and from the
+ * system tick interrupt in internal and master mode.
+ * The pattern steps are only played while a chord button is pressed. If
+ * the step's MIDI messages were prepared ahead of time, they are released
+ * to the USB transmit queue right here. A step prepared for another beat,
+ * e.g. before the transport was stopped and started over, is sent as-is
+ * to keep the note states in line, the actual beat then gets played from
+ * playback_poll().
+ */
+void
+playback_clock_step(void)
+{
+    if (playback_clock_restart) {
+        count = 0;
+        playback_clock_restart = 0;
+    } else if (++count >= playback_metre_count()) {
+        count = 0;
+    }
+
+    if (held && !(pattern_flags & PATTERN_FLAG_HOLD)) {
+        switch (step_state) {
+            case STEP_PREPARED:
+                step_commit();
+                /* fall through */
+            case STEP_SENT:
+                if (step_beat == count) {
+                    step_state = STEP_PLAYED;
+                } else {
+                    step_state = STEP_IDLE;
+                    ring_put(&step_ring, count);
+                }
+                break;
+            case STEP_RENDERING:
+                step_state = STEP_LATE;
+                break;
+            default:
+                /* nothing prepared in time, playback_poll() plays it */
+                ring_put(&step_ring, count);
+                break;
+        }
+    }
+}
+
+/**
+ * Reset the playback to the beginning of the bar.
+ * Called when the external MIDI clock is started, the next call to
+ * playback_clock_step() will then start over with the first beat.
+ */
+void
+playback_clock_start(void)
+{
+    playback_clock_restart = 1;
+}
+
+/**
+ * Cancel the scheduled note-off of a given note, if there is one.
+ * @param note MIDI note to cancel the note-off for
+ * @return 1 if a pending note-off was cancelled, 0 otherwise
+ */
+static uint8_t
+note_off_cancel(uint8_t note)
+{
+    uint8_t cancelled = 0;
+    uint8_t i;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        for (i = 0; i < PLAYBACK_NOTE_OFF_SLOTS; i++) {
+            if (note_offs[i].note == note && note_offs[i].remaining > 0) {
+                note_offs[i].remaining = 0;
+                cancelled = 1;
+            }
+        }
+    }
+
+    return cancelled;
+}
+
+/**
+ * Schedule a note-off for a given note after the current gate length.
+ * For a step prepared ahead of time, the gate starts once the step is
+ * committed, so the note-off can't get ahead of its note-on. If all slots
+ * are taken, the note is held until the chord button release.
+ *
+ * @param note MIDI note to schedule the note-off for
+ */
+static void
+note_off_schedule(uint8_t note)
+{
+    uint8_t i;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        for (i = 0; i < PLAYBACK_NOTE_OFF_SLOTS; i++) {
+            if (note_offs[i].remaining == 0) {
+                note_offs[i].note = note;
+                note_offs[i].remaining = gate_ticks;
+                note_offs[i].staged = rendering;
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * Cancel all scheduled note-offs.
+ */
+static void
+note_off_cancel_all(void)
+{
+    uint8_t i;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        for (i = 0; i < PLAYBACK_NOTE_OFF_SLOTS; i++) {
+            note_offs[i].remaining = 0;
+        }
+    }
+}
+
+/**
+ * Set up the gate length for the notes of the next cycle step.
+ * The gate applies only to patterns with cycle steps, the notes of chord
+ * holding patterns are held until the chord button is released.
  */
 static void
-playback_cycle_timer_callback(void)
+gate_update(void)
+{
+    uint8_t gate = gates[pattern_mode];
+
+    if ((pattern_flags & PATTERN_FLAG_HOLD) || gate >= PLAYBACK_GATE_MAX) {
+        gate_ticks = 0;
+    } else {
+        gate_ticks = ((uint32_t) clock_step_ticks() * gate) / 100;
+        if (gate_ticks == 0) {
+            gate_ticks = 1;
+        }
+    }
+}
+
+/**
+ * Playback system tick handler.
+ * Counts down the scheduled note-offs and sends them once they are due.
+ * Called from the system tick interrupt handler.
+ */
+void
+playback_systick(void)
+{
+    volatile note_off_t *note_off;
+    uint8_t i;
+
+    for (i = 0; i < PLAYBACK_NOTE_OFF_SLOTS; i++) {
+        note_off = &note_offs[i];
+        if (note_off->remaining > 0 && !note_off->staged &&
+                --note_off->remaining == 0)
+        {
+            note_map[note_off->note >> 3] &= ~(1 << (note_off->note & 0x07));
+            midi_msg_note_off_irq(note_off->note, VELOCITY);
+        }
+    }
+}
+
+/**
+ * Get the EEPROM location of the gate length setting for a given mode.
+ * Built-in modes have theirs in the settings struct, user patterns in
+ * their pattern directory entry.
+ *
+ * @param mode Playback mode
+ * @return Pointer to the gate length value in the EEPROM
+ */
+static uint8_t *
+gate_eeprom_address(playback_mode_item_t mode)
 {
-    if (++playback_mode->count == playback_metre_count()) {
-        playback_mode->count = 0;
+    if (mode >= PLAYBACK_MODE_USER) {
+        return &eeprom_data.user_patterns.directory[mode - PLAYBACK_MODE_USER].gate;
+    }
+    return &eeprom_data.settings.gate[mode];
+}
+
+/**
+ * Initialize the playback.
+ * Reads the gate length settings of each playback mode, the chord voicing,
+ * the chord release, and the chord change quantization setting from the
+ * EEPROM.
+ */
+void
+playback_init(void)
+{
+    uint8_t i;
+
+    voicing = eeprom_read_byte(&eeprom_data.settings.voicing);
+    if ((voicing & ~(PLAYBACK_VOICING_SEVENTH | PLAYBACK_VOICING_LEAD |
+                    PLAYBACK_VOICING_INVERSION_MASK)) ||
+            (!(voicing & PLAYBACK_VOICING_SEVENTH) &&
+             (voicing & PLAYBACK_VOICING_INVERSION_MASK) >= VOICING_TRIAD_INVERSIONS))
+    {
+        voicing = 0;
+        eeprom_update_byte(&eeprom_data.settings.voicing, voicing);
+    }
+
+    release = eeprom_read_byte(&eeprom_data.settings.release);
+    if (release >= PLAYBACK_RELEASE_MAX) {
+        release = PLAYBACK_RELEASE_NOTE_OFF;
+        eeprom_update_byte(&eeprom_data.settings.release, release);
+    }
+
+    quantize = eeprom_read_byte(&eeprom_data.settings.quantize);
+    if (quantize >= PLAYBACK_QUANTIZE_MAX) {
+        quantize = PLAYBACK_QUANTIZE_OFF;
+        eeprom_update_byte(&eeprom_data.settings.quantize, quantize);
+    }
+
+    for (i = 0; i < PLAYBACK_MODE_MAX; i++) {
+        gates[i] = eeprom_read_byte(gate_eeprom_address(i));
+
+        if (gates[i] == 0 || gates[i] > PLAYBACK_GATE_MAX) {
+            gates[i] = PLAYBACK_GATE_DEFAULT;
+            eeprom_update_byte(gate_eeprom_address(i), PLAYBACK_GATE_DEFAULT);
+        }
+    }
+}
+
+/**
+ * Select the next gate length for the current playback mode.
+ * Cycles through the gate lengths in PLAYBACK_GATE_STEP steps and stores
+ * the new value in the EEPROM.
+ */
+void
+playback_gate_next(void)
+{
+    uint8_t mode = menu_get_current_playback_mode();
+    uint8_t gate = gates[mode] + PLAYBACK_GATE_STEP;
+
+    if (gate > PLAYBACK_GATE_MAX) {
+        gate = PLAYBACK_GATE_STEP;
+    }
+
+    gates[mode] = gate;
+    eeprom_update_byte(gate_eeprom_address(mode), gate);
+
+    uart_print_pgm(gate_string);
+    uart_putint(gate, 1);
+    uart_print_pgm(gate_percent_string);
+}
+
+/**
+ * Select the next chord inversion.
+ * Cycles through root position and all inversions of the current chord
+ * type, and stores the new value in the EEPROM.
+ */
+void
+playback_inversion_next(void)
+{
+    uint8_t inversion = (voicing & PLAYBACK_VOICING_INVERSION_MASK) + 1;
+    uint8_t max = (voicing & PLAYBACK_VOICING_SEVENTH)
+            ? VOICING_SEVENTH_INVERSIONS : VOICING_TRIAD_INVERSIONS;
+
+    if (inversion >= max) {
+        inversion = 0;
+    }
+
+    voicing = (voicing & ~PLAYBACK_VOICING_INVERSION_MASK) | inversion;
+    eeprom_update_byte(&eeprom_data.settings.voicing, voicing);
+    last_chord_num = NO_CHORD;
+
+    uart_print_pgm(inversion_string);
+    uart_putint(inversion, 1);
+    uart_newline();
+}
+
+/**
+ * Toggle the added seventh for all chords.
+ * Stores the new value in the EEPROM.
+ */
+void
+playback_seventh_toggle(void)
+{
+    voicing ^= PLAYBACK_VOICING_SEVENTH;
+
+    if (!(voicing & PLAYBACK_VOICING_SEVENTH) &&
+            (voicing & PLAYBACK_VOICING_INVERSION_MASK) >= VOICING_TRIAD_INVERSIONS)
+    {
+        /* triads have no third inversion */
+        voicing &= ~PLAYBACK_VOICING_INVERSION_MASK;
+    }
+    eeprom_update_byte(&eeprom_data.settings.voicing, voicing);
+    /* the last inversion may not exist for the other chord type */
+    last_chord_num = NO_CHORD;
+
+    uart_print_pgm(seventh_string);
+    uart_print_pgm((voicing & PLAYBACK_VOICING_SEVENTH) ? on_string : off_string);
+}
+
+/**
+ * Toggle the voice leading between chord changes.
+ * When enabled, each chord is played in the inversion closest to the
+ * previous chord, instead of the selected one. Stores the new value in
+ * the EEPROM.
+ */
+void
+playback_voice_leading_toggle(void)
+{
+    voicing ^= PLAYBACK_VOICING_LEAD;
+    eeprom_update_byte(&eeprom_data.settings.voicing, voicing);
+    last_chord_num = NO_CHORD;
+
+    uart_print_pgm(voice_leading_string);
+    uart_print_pgm((voicing & PLAYBACK_VOICING_LEAD) ? on_string : off_string);
+}
+
+/**
+ * Get the number of held chords playing a given MIDI note.
+ * @param note MIDI note
+ * @return Reference count of the note
+ */
+static uint8_t
+note_ref_get(uint8_t note)
+{
+    uint8_t refs = note_refs[note >> 1];
+
+    return (note & 0x01) ? (refs >> 4) : (refs & 0x0f);
+}
+
+/**
+ * Set the number of held chords playing a given MIDI note.
+ * @param note MIDI note
+ * @param count New reference count of the note
+ */
+static void
+note_ref_set(uint8_t note, uint8_t count)
+{
+    uint8_t *refs = &note_refs[note >> 1];
+
+    if (note & 0x01) {
+        *refs = (*refs & 0x0f) | (count << 4);
+    } else {
+        *refs = (*refs & 0xf0) | count;
+    }
+}
+
+/**
+ * Check if a given MIDI note is currently sounding.
+ * @param note MIDI note
+ * @return non-zero if a note on was sent without a note off yet
+ */
+static uint8_t
+note_sounding(uint8_t note)
+{
+    return note_map[note >> 3] & (1 << (note & 0x07));
+}
+
+/**
+ * Take a reference on a MIDI note for a held chord, and start it.
+ * The note is not triggered again if another held chord is playing it
+ * already, unless the pattern step restarts a sounding chord tone. Either
+ * way, each note starts only once per pattern step.
+ *
+ * @param note MIDI note
+ * @param velocity Note on velocity
+ * @param restart 1 if the chord tone is already sounding, 0 otherwise
+ */
+static void
+note_acquire(uint8_t note, uint8_t velocity, uint8_t restart)
+{
+    uint8_t mask = 1 << (note & 0x07);
+
+    if (!restart) {
+        note_ref_set(note, note_ref_get(note) + 1);
+    }
+
+    if ((restart || !note_sounding(note)) && !(step_triggered[note >> 3] & mask)) {
+        play_start_note(note, velocity);
+        step_triggered[note >> 3] |= mask;
+    }
+}
+
+/**
+ * Drop a reference on a MIDI note for a held chord.
+ * The note is only stopped once no other held chord is playing it.
+ *
+ * @param note MIDI note
+ */
+static void
+note_release(uint8_t note)
+{
+    uint8_t refs = note_ref_get(note);
+
+    if (refs > 0) {
+        note_ref_set(note, --refs);
+        if (refs == 0) {
+            play_stop_note(note);
+        }
+    }
+}
+
+/**
+ * Start the voicing notes of a given chord tone of a held chord.
+ * The octave chord tone covers all the notes at the top of the voicing.
+ *
+ * @param chord_num Chord number
+ * @param tone Chord tone
+ * @param velocity Note on velocity
+ * @param restart 1 if the chord tone is already sounding, 0 otherwise
+ */
+static void
+chord_tone_on(uint8_t chord_num, uint8_t tone, uint8_t velocity, uint8_t restart)
+{
+    chord_t *chord = &chords[chord_num];
+    uint8_t last = (tone == CHORD_OCTAVE) ? chord->length - 1 : tone;
+
+    for (; tone <= last; tone++) {
+        note_acquire(chord->notes[tone], velocity, restart);
+    }
+}
+
+/**
+ * Stop the voicing notes of a given chord tone of a held chord.
+ * The octave chord tone covers all the notes at the top of the voicing.
+ *
+ * @param chord_num Chord number
+ * @param tone Chord tone
+ */
+static void
+chord_tone_off(uint8_t chord_num, uint8_t tone)
+{
+    chord_t *chord = &chords[chord_num];
+    uint8_t last = (tone == CHORD_OCTAVE) ? chord->length - 1 : tone;
+
+    for (; tone <= last; tone++) {
+        note_release(chord->notes[tone]);
+    }
+}
+
+/**
+ * Press or release the sustain pedal, unless it already is in that state.
+ * @param down 1 to press the pedal, 0 to release it
+ */
+static void
+sustain_set(uint8_t down)
+{
+    if (down != sustain_down) {
+        if (rendering) {
+            midi_stage_control_change(MIDI_CC_SUSTAIN, down ? 0x7f : 0);
+        } else {
+            midi_msg_control_change(MIDI_CC_SUSTAIN, down ? 0x7f : 0);
+        }
+        sustain_down = down;
+    }
+}
+
+/**
+ * Release and press the sustain pedal again, and restart all held chords.
+ * This stops all notes held by the pedal at once, the sounding chord tones
+ * of every held chord are then started anew. A given new chord takes its
+ * note references at that point, all other chords already hold theirs.
+ *
+ * @param new_chord Chord number of a newly pressed chord, or NO_CHORD
+ */
+static void
+sustain_restart(uint8_t new_chord)
+{
+    uint8_t chord_num;
+    uint8_t tone;
+
+    sustain_set(0);
+    sustain_set(1);
+    memset(step_triggered, 0, sizeof(step_triggered));
+
+    for (chord_num = 0; chord_num < PLAYBACK_CHORD_MAX; chord_num++) {
+        if (held & (1 << chord_num)) {
+            for (tone = 0; tone < CHORD_TONES; tone++) {
+                if (sounding & (1 << tone)) {
+                    chord_tone_on(chord_num, tone, PATTERN_VELOCITY, chord_num != new_chord);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Select the next chord release strategy.
+ * With the sustain strategy, every note gets its note off right after the
+ * note on while the sustain pedal (CC64) is held down, and a chord change
+ * or release only sends a single sustain pedal release. The note off
+ * strategy stops each note on its own for synths that ignore the sustain
+ * pedal. Stores the new value in the EEPROM.
+ */
+void
+playback_release_next(void)
+{
+    if (++release == PLAYBACK_RELEASE_MAX) {
+        release = 0;
+    }
+    /* don't leave notes hanging on the pedal */
+    sustain_set(0);
+    eeprom_update_byte(&eeprom_data.settings.release, release);
+
+    uart_print_pgm(release_string);
+    uart_print_pgm((release == PLAYBACK_RELEASE_SUSTAIN)
+            ? release_sustain_string : release_note_off_string);
+}
+
+/**
+ * Play the pattern step for the given beat count.
+ * Stops the step's chord tones to turn off first, then starts the ones to
+ * turn on, in order from root to octave, for each held chord.
+ *
+ * @param beat Beat count
+ */
+static void
+pattern_play_step(uint8_t beat)
+{
+    pattern_step_t step;
+    uint8_t chord_num;
+    uint8_t tone;
+    uint8_t bit;
+
+    pattern_get_step(pattern_mode, beat % pattern_length, &step);
+    memset(step_triggered, 0, sizeof(step_triggered));
+
+    for (tone = 0, bit = 1; tone < CHORD_TONES; tone++, bit <<= 1) {
+        if (step.off & bit & sounding) {
+            for (chord_num = 0; chord_num < PLAYBACK_CHORD_MAX; chord_num++) {
+                if (held & (1 << chord_num)) {
+                    chord_tone_off(chord_num, tone);
+                }
+            }
+        }
+    }
+    sounding &= ~step.off;
+
+    for (tone = 0, bit = 1; tone < CHORD_TONES; tone++, bit <<= 1) {
+        if (step.on & bit) {
+            for (chord_num = 0; chord_num < PLAYBACK_CHORD_MAX; chord_num++) {
+                if (held & (1 << chord_num)) {
+                    chord_tone_on(chord_num, tone, step.velocity, sounding & bit);
+                }
+            }
+        }
+    }
+    sounding |= step.on;
+}
+
+/**
+ * Finish rendering the next pattern step into the stage queue.
+ * If the step's clock came in the meantime, the step is sent right away.
+ */
+static void
+pattern_step_rendered(void)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        if (step_state == STEP_LATE) {
+            /* already due, send it right away */
+            step_commit();
+            if (step_beat == count) {
+                step_state = STEP_PLAYED;
+            } else {
+                /* clock started over meanwhile, play the actual beat too */
+                step_state = STEP_IDLE;
+                ring_put(&step_ring, count);
+            }
+        } else {
+            step_state = STEP_PREPARED;
+        }
+    }
+}
+
+/**
+ * Get the max number of MIDI messages a chord change can send.
+ * Each note of the held and the newly pressed chords can get a note-on and
+ * up to two note-offs, either for restarting it, retriggering it, or the
+ * sustain pedal, plus a sustain pedal release and press.
+ *
+ * @param pressed Chord buttons pressed by the change, one bit per chord
+ * @return Upper limit of the chord change's number of MIDI messages
+ */
+static uint8_t
+chord_change_messages(uint8_t pressed)
+{
+    uint8_t chord_num;
+    uint8_t notes = (voicing & PLAYBACK_VOICING_SEVENTH)
+            ? VOICING_SEVENTH_NOTES : VOICING_TRIAD_NOTES;
+    uint8_t messages = 2;
+
+    for (chord_num = 0; chord_num < PLAYBACK_CHORD_MAX; chord_num++) {
+        if (held & (1 << chord_num)) {
+            messages += 3 * chords[chord_num].length;
+        } else if (pressed & (1 << chord_num)) {
+            messages += 3 * notes;
+        }
+    }
+
+    return messages;
+}
+
+/**
+ * Get the max number of MIDI messages a pattern step can send.
+ * Every stopped note sends at most a note-off, every started note at most
+ * a note-on plus a note-off, either for a retriggered note or the sustain
+ * pedal. A latched chord change applied along with the step comes on top.
+ *
+ * @param beat Beat count of the step
+ * @return Upper limit of the step's number of MIDI messages
+ */
+static uint8_t
+pattern_step_messages(uint8_t beat)
+{
+    pattern_step_t step;
+    uint8_t chord_num;
+    uint8_t tone;
+    uint8_t bit;
+    uint8_t notes;
+    uint8_t messages = 0;
+
+    pattern_get_step(pattern_mode, beat % pattern_length, &step);
+
+    for (chord_num = 0; chord_num < PLAYBACK_CHORD_MAX; chord_num++) {
+        if (!(held & (1 << chord_num))) {
+            continue;
+        }
+        for (tone = 0, bit = 1; tone < CHORD_TONES; tone++, bit <<= 1) {
+            notes = (tone == CHORD_OCTAVE) ? chords[chord_num].length - tone : 1;
+            if (step.off & bit & sounding) {
+                messages += notes;
+            }
+            if (step.on & bit) {
+                messages += 2 * notes;
+            }
+        }
+    }
+
+    if (latched && quantize_boundary(beat)) {
+        messages += chord_change_messages(latched);
+    }
+
+    return messages;
+}
+
+/**
+ * Prepare the next pattern step ahead of time.
+ * Plays the step for the next beat count with all its MIDI messages going
+ * to the USB stage queue, from where playback_clock_step() releases them
+ * once the step is due. The note states are updated right away, so any
+ * chord change before that point has to send the prepared step first.
+ * A step that might not fit in the stage queue isn't prepared, it's played
+ * from playback_poll() once it's due instead.
+ */
+static void
+pattern_prepare_step(void)
+{
+    uint8_t prepare = 0;
+    uint8_t beat = 0;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        if (step_state == STEP_IDLE && ring_count(&step_ring) == 0) {
+            step_state = STEP_RENDERING;
+            prepare = 1;
+            if (!playback_clock_restart && count + 1 < playback_metre_count()) {
+                beat = count + 1;
+            }
+        }
+    }
+
+    if (!prepare) {
+        return;
+    }
+
+    if (pattern_step_messages(beat) > usb_midi_stage_space()) {
+        /* doesn't fit in the stage, playback_poll() plays it on the clock */
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            if (step_state == STEP_LATE) {
+                ring_put(&step_ring, count);
+            }
+            step_state = STEP_IDLE;
+        }
+        return;
+    }
+
+    step_beat = beat;
+    rendering = 1;
+    gate_update();
+    pattern_play_step(beat);
+    /* latched chord changes go out right along with the step */
+    quantize_apply(beat);
+    rendering = 0;
+
+    pattern_step_rendered();
+}
+
+/**
+ * Send a prepared pattern step right away.
+ * Chord changes build on the note states the prepared step already set up,
+ * so its messages need to go out ahead of the chord change's ones.
+ */
+static void
+pattern_flush_step(void)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        if (step_state == STEP_PREPARED) {
+            step_commit();
+            step_state = STEP_SENT;
+        }
     }
-    playback_timer_triggered = 1;
 }
 
 /**
  * Playback mode poll function.
- * If the cycle callback function is used by the playback mode, a timer is
- * started according to the currently selected playback tempo. This function
- * polls the status of the timer interrupt; if the cycle period is elapsed,
- * the cycle callback function is executed.
+ * Unless the playback mode's pattern only holds the chord, the clock
+ * advances the playback steps according to the current tempo. This function
+ * prepares the next step's MIDI messages once it is less than
+ * PLAYBACK_LOOKAHEAD_MS away, so the clock only needs to release them. If
+ * the cycle period elapsed without a prepared step, the pattern step for
+ * the current beat count is played right here instead.
  */
 void
 playback_poll(void)
 {
-    if (playback_timer_triggered) {
-        if (playback_mode->cycle != NULL) {
-            playback_mode->cycle(&chord);
+    uint8_t beat;
+
+    while (ring_get(&step_ring, &beat)) {
+        if (held) {
+            gate_update();
+            pattern_play_step(beat);
+            quantize_apply(beat);
+            gui_set_metronome(beat);
+        }
+    }
+
+    if (step_state == STEP_PLAYED) {
+        if (latched_step) {
+            /* boundary step is out, apply the chord change right after it */
+            quantize_apply(step_beat);
+        }
+        gui_set_metronome(count);
+        step_state = STEP_IDLE;
+    }
+
+    if (held && !(pattern_flags & PATTERN_FLAG_HOLD) &&
+            clock_step_remaining() <= TIMER_MS(PLAYBACK_LOOKAHEAD_MS))
+    {
+        pattern_prepare_step();
+    }
+}
+
+
+/**
+ * Release a held chord.
+ * Stops the chord's notes no other held chord is playing, and stops the
+ * playback if it was the last held chord.
+ *
+ * @param chord_num Chord number
+ */
+static void
+chord_release(uint8_t chord_num)
+{
+    uint8_t tone;
+
+    pattern_flush_step();
+
+    for (tone = 0; tone < CHORD_TONES; tone++) {
+        if (sounding & (1 << tone)) {
+            chord_tone_off(chord_num, tone);
+        }
+    }
+    held &= ~(1 << chord_num);
+
+    if (!held) {
+        if (clock_get_mode() == CLOCK_MODE_INTERNAL) {
+            clock_transport_stop();
+            count = 0;
+        }
+
+        note_off_cancel_all();
+        sustain_set(0);
+        sounding = 0;
+        step_state = STEP_IDLE;
+        gui_set_metronome(0xff);
+    }
+}
+
+/**
+ * Legato timer callback function.
+ * No other chord button was pressed in time after the last one was released,
+ * so its chord is stopped after all.
+ */
+static void
+legato_expired(void)
+{
+    uint8_t chord_num = legato_chord;
+
+    if (latched && clock_transport_running()) {
+        /* a chord change is due on the next boundary, keep on sounding */
+        timer_start(TIMER_LEGATO, TIMER_MS(PLAYBACK_LEGATO_MS), 0, legato_expired);
+        return;
+    }
+    latched = 0;
+    latched_released = 0;
+
+    if (chord_num != NO_CHORD) {
+        legato_chord = NO_CHORD;
+        chord_release(chord_num);
+    }
+}
+
+/**
+ * Press a chord button.
+ * A chord pressed while others are held joins the ongoing pattern, starting
+ * only the notes no other held chord is playing already.
+ *
+ * @param chord_num Chord number
+ */
+static void
+chord_press(uint8_t chord_num)
+{
+    uint8_t tone;
+    uint8_t beat;
+
+    if (chord_num == legato_chord) {
+        /* pressed again in time, just keep on playing */
+        timer_stop(TIMER_LEGATO);
+        legato_chord = NO_CHORD;
+        gui_set_list_chord(chord_num, 1);
+        return;
+    }
+
+    if (held & (1 << chord_num)) {
+        return;
+    }
+
+    pattern_flush_step();
+    construct_chord(chord_num);
+
+    if (held && release == PLAYBACK_RELEASE_SUSTAIN) {
+        held |= (1 << chord_num);
+
+        if (legato_chord != NO_CHORD) {
+            /* the notes are held by the pedal, no note offs are sent here */
+            timer_stop(TIMER_LEGATO);
+            chord_release(legato_chord);
+            legato_chord = NO_CHORD;
+        }
+        sustain_restart(chord_num);
+
+    } else if (held) {
+        memset(step_triggered, 0, sizeof(step_triggered));
+        held |= (1 << chord_num);
+
+        for (tone = 0; tone < CHORD_TONES; tone++) {
+            if (sounding & (1 << tone)) {
+                chord_tone_on(chord_num, tone, PATTERN_VELOCITY, 0);
+            }
+        }
+
+        if (legato_chord != NO_CHORD) {
+            /* legato change, stops only what the new chord doesn't play */
+            timer_stop(TIMER_LEGATO);
+            chord_release(legato_chord);
+            legato_chord = NO_CHORD;
+        }
+    } else {
+        pattern_mode = menu_get_current_playback_mode();
+        pattern_length = pattern_get_length(pattern_mode);
+        if (pattern_length == 0) {
+            /* deleted user pattern, nothing to play */
+            return;
+        }
+
+        /* the clock steps may come from interrupt context */
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            pattern_flags = pattern_get_flags(pattern_mode);
+
+            if (clock_get_mode() != CLOCK_MODE_SLAVE && !clock_transport_running()) {
+                /* starting the clock transport, this is the first beat */
+                count = 0;
+                clock_transport_start();
+            }
+            /* otherwise stay in phase with the running clock */
+            beat = count;
+        }
+
+        held = (1 << chord_num);
+        if (release == PLAYBACK_RELEASE_SUSTAIN) {
+            sustain_set(1);
+        }
+        gate_update();
+        pattern_play_step((pattern_flags & PATTERN_FLAG_HOLD) ? 0 : beat);
+
+        if (!(pattern_flags & PATTERN_FLAG_HOLD)) {
+            gui_set_metronome(beat);
+        }
+    }
+
+    gui_set_list_chord(chord_num, 1);
+}
+
+/**
+ * Release a chord button.
+ * Only the notes no other held chord is playing are stopped, the last
+ * chord keeps sounding for PLAYBACK_LEGATO_MS.
+ *
+ * @param chord_num Chord number
+ */
+static void
+chord_unpress(uint8_t chord_num)
+{
+    if (!(held & (1 << chord_num)) || chord_num == legato_chord) {
+        return;
+    }
+
+    gui_set_list_chord(chord_num, 0);
+
+    if (held == (1 << chord_num)) {
+        legato_chord = chord_num;
+        timer_start(TIMER_LEGATO, TIMER_MS(PLAYBACK_LEGATO_MS), 0, legato_expired);
+    } else {
+        chord_release(chord_num);
+        if (release == PLAYBACK_RELEASE_SUSTAIN) {
+            sustain_restart(NO_CHORD);
         }
-        lcd_set_metronome(playback_mode->count);
+    }
+}
+
+/**
+ * Check if a given beat count is a chord change boundary.
+ * @param beat Beat count
+ * @return 1 if latched chord changes are applied on this beat, 0 otherwise
+ */
+static uint8_t
+quantize_boundary(uint8_t beat)
+{
+    if (quantize == PLAYBACK_QUANTIZE_BAR) {
+        return beat == 0;
+    }
+    /* two 1/8 note steps per beat */
+    return (beat & 0x01) == 0;
+}
+
+/**
+ * Add a chord change to the prepared step on the chord change boundary.
+ * The chord is pressed with its MIDI messages going to the stage queue as
+ * well, so the change goes out along with the step on the clock.
+ *
+ * @param chord_num Chord number
+ * @return 1 if the chord change was added, 0 if the step is sent already,
+ *         or the chord change might not fit in the stage queue
+ */
+static uint8_t
+quantize_join_step(uint8_t chord_num)
+{
+    uint8_t join = 0;
+
+    if (chord_change_messages(1 << chord_num) > usb_midi_stage_space()) {
+        return 0;
+    }
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        if (step_state == STEP_PREPARED) {
+            step_state = STEP_RENDERING;
+            join = 1;
+        }
+    }
 
-        playback_timer_triggered = 0;
+    if (!join) {
+        return 0;
     }
+
+    rendering = 1;
+    chord_press(chord_num);
+    rendering = 0;
+
+    pattern_step_rendered();
+    return 1;
 }
 
+/**
+ * Check if a chord button press came within the step before a boundary
+ * that already passed.
+ * The press event may only get handled after the clock advanced past the
+ * boundary, e.g. while the main loop was busy with the LCD or USB, so the
+ * boundary is chosen by the time of the press itself.
+ *
+ * @param stamp System tick of the chord button press
+ * @return 1 if the current step is a boundary that started after the press
+ */
+static uint8_t
+quantize_missed(uint16_t stamp)
+{
+    uint16_t started;
+    uint16_t before;
+    uint8_t beat;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        started = clock_step_start();
+        beat = count;
+    }
+    /* ticks the press came before the current step, negative if after */
+    before = started - stamp;
+
+    return (int16_t) before > 0 && before <= clock_step_ticks() &&
+            quantize_boundary(beat);
+}
+
+/**
+ * Latch a chord button press until the next chord change boundary.
+ * Only chord changes are quantized, i.e. presses while the pattern is
+ * already playing with a running clock. The boundary is chosen by the time
+ * of the press, so a press right before a boundary that is handled after it
+ * still changes the chord right away, or along with the next step if that
+ * is already prepared. If the step on the boundary is already prepared, the
+ * press is too close to it to wait for the next one, and the chord change
+ * is added to the prepared step instead. If that's not possible, the press
+ * is applied right after the step is sent, so the chord never changes ahead
+ * of the boundary.
+ *
+ * @param chord_num Chord number
+ * @param stamp System tick of the chord button press
+ * @return 1 if the press got latched, 0 if it needs to be handled now
+ */
+static uint8_t
+quantize_latch(uint8_t chord_num, uint16_t stamp)
+{
+    if (quantize == PLAYBACK_QUANTIZE_OFF || !held ||
+            (pattern_flags & PATTERN_FLAG_HOLD) ||
+            (held & (1 << chord_num)) || chord_num == legato_chord ||
+            !clock_transport_running())
+    {
+        return 0;
+    }
+
+    if (quantize_missed(stamp)) {
+        /* the boundary passed already, don't send a prepared step early */
+        return step_state == STEP_PREPARED && quantize_join_step(chord_num);
+    }
+
+    if (step_state == STEP_PREPARED && quantize_boundary(step_beat)) {
+        if (quantize_join_step(chord_num)) {
+            return 1;
+        }
+        latched_step = 1;
+    }
+
+    latched |= (1 << chord_num);
+    latched_released &= ~(1 << chord_num);
+    gui_set_list_chord(chord_num, 1);
+
+    return 1;
+}
+
+/**
+ * Apply all latched chord changes, if the given beat is a boundary.
+ * Presses the latched chord buttons first, so a legato chord change stops
+ * only the notes that differ, then releases the ones that were let go
+ * already before the boundary.
+ *
+ * @param beat Beat count of the step just played
+ */
+static void
+quantize_apply(uint8_t beat)
+{
+    uint8_t pressed = latched;
+    uint8_t released = latched_released;
+    uint8_t chord_num;
+
+    if (!pressed || !quantize_boundary(beat)) {
+        return;
+    }
+    latched = 0;
+    latched_released = 0;
+    latched_step = 0;
+
+    for (chord_num = 0; chord_num < PLAYBACK_CHORD_MAX; chord_num++) {
+        if (pressed & (1 << chord_num)) {
+            chord_press(chord_num);
+        }
+    }
+
+    for (chord_num = 0; chord_num < PLAYBACK_CHORD_MAX; chord_num++) {
+        if (released & (1 << chord_num)) {
+            chord_unpress(chord_num);
+        }
+    }
+}
+
+/**
+ * Select the next chord change quantization.
+ * With quantization enabled, a chord change while the pattern is playing
+ * is latched and applied on the next beat or bar, keeping the clock and the
+ * pattern in phase. Stores the new value in the EEPROM.
+ */
+void
+playback_quantize_next(void)
+{
+    if (++quantize == PLAYBACK_QUANTIZE_MAX) {
+        quantize = 0;
+    }
+    eeprom_update_byte(&eeprom_data.settings.quantize, quantize);
+
+    if (quantize == PLAYBACK_QUANTIZE_OFF) {
+        /* nothing waits for a boundary anymore, change chords right away */
+        quantize_apply(0);
+    }
+
+    uart_print_pgm(quantize_string);
+    switch (quantize) {
+        case PLAYBACK_QUANTIZE_BEAT:
+            uart_print_pgm(quantize_beat_string);
+            break;
+        case PLAYBACK_QUANTIZE_BAR:
+            uart_print_pgm(quantize_bar_string);
+            break;
+        default:
+            uart_print_pgm(off_string);
+            break;
+    }
+}
 
 /**
  * Button press callback function.
  * Called when one of the four chord buttons is pressed. The pressed chord
  * button number is given in the arg parameter.
  *
+ * Several chord buttons can be held at once. A chord pressed while others
+ * are held joins the ongoing pattern, starting only the notes no other held
+ * chord is playing already. With quantization enabled, the chord change
+ * waits for the next beat or bar after the time of the press, see
+ * button_event_time().
+ *
  * @param arg Pressed button number, given as pointer to uint8_t
  */
 void
@@ -189,19 +1379,8 @@ playback_button_press(void *arg)
 {
     uint8_t chord_num = *((uint8_t *) arg);
 
-    if (!pressed) {
-        construct_chord(chord_num);
-        playback_mode = playback_modes[menu_get_current_playback_mode()];
-        if (playback_mode->start != NULL) {
-            playback_mode->start(&chord);
-        }
-
-        if (playback_mode->cycle != NULL) {
-            lcd_set_metronome(0);
-            timer1_start(playback_interval(), playback_cycle_timer_callback);
-        }
-        pressed = 1;
-        lcd_set_list_chord(chord_num, 1);
+    if (!quantize_latch(chord_num, button_event_time())) {
+        chord_press(chord_num);
     }
 }
 
@@ -210,47 +1389,125 @@ playback_button_press(void *arg)
  * Called when one of the four chord buttons is released. The released chord
  * button number is given in the arg parameter.
  *
- * @param arg Released button number, given as pointer to uint8_t (unused)
+ * Only the notes no other held chord is playing are stopped, the playback
+ * itself stops once the last chord button is released. The last chord keeps
+ * sounding for PLAYBACK_LEGATO_MS though, and if another chord button gets
+ * pressed within that time, only the notes that differ between the two
+ * chords are stopped and started. With quantization enabled, it keeps on
+ * sounding until a latched chord change is applied.
+ *
+ * @param arg Released button number, given as pointer to uint8_t
  */
 void
 playback_button_release(void *arg)
 {
     uint8_t chord_num = *((uint8_t *) arg);
 
-    pressed = 0;
-    timer1_stop();
-    playback_mode->count = 0;
+    if (latched & (1 << chord_num)) {
+        /* the chord still changes on the boundary, then stops right away */
+        latched_released |= (1 << chord_num);
+        gui_set_list_chord(chord_num, 0);
+        return;
+    }
 
-    if (playback_mode->stop != NULL) {
-        playback_mode->stop(&chord);
+    chord_unpress(chord_num);
+}
+
+
+/**
+ * Send a MIDI Note On message, or stage it while preparing a pattern step.
+ * @param note MIDI note
+ * @param velocity MIDI note velocity
+ */
+static void
+note_on_send(uint8_t note, uint8_t velocity)
+{
+    if (rendering) {
+        midi_stage_note_on(note, velocity);
+    } else {
+        midi_msg_note_on(note, velocity);
     }
-    lcd_set_list_chord(chord_num, 0);
-    lcd_set_metronome(0xff);
 }
 
+/**
+ * Send a MIDI Note Off message, or stage it while preparing a pattern step.
+ * @param note MIDI note
+ */
+static void
+note_off_send(uint8_t note)
+{
+    if (rendering) {
+        midi_stage_note_off(note, VELOCITY);
+    } else {
+        midi_msg_note_off(note, VELOCITY);
+    }
+}
 
 /**
  * Start playing a given MIDI note.
- * Sends the note via USB as MIDI Note On message.
+ * Sends the note via USB as MIDI Note On message. If the current playback
+ * mode has a gate length set, the matching Note Off message is scheduled
+ * to be sent from the system tick interrupt once the gate time is over.
+ * While the sustain pedal is held down, the Note Off is sent right away.
  *
  * @param note MIDI note to start playing
+ * @param velocity MIDI note velocity
  */
 void
-play_start_note(uint8_t note)
+play_start_note(uint8_t note, uint8_t velocity)
 {
-    midi_msg_note_on(note, VELOCITY);
+    /* a retriggered note gets a new note-off */
+    if (note_off_cancel(note) && rendering) {
+        /* the old one was due before the prepared step */
+        midi_stage_note_off(note, VELOCITY);
+    }
+    note_on_send(note, velocity);
+
+    if (sustain_down) {
+        /* the pedal keeps the note playing until it is released */
+        note_off_send(note);
+        return;
+    }
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        note_map[note >> 3] |= (1 << (note & 0x07));
+    }
+
+    if (gate_ticks > 0) {
+        note_off_schedule(note);
+    }
 }
 
 /**
  * Stop playing a given MIDI note.
- * Sends the note via USB as MIDI Note Off message.
+ * Sends the note via USB as MIDI Note Off message, unless it isn't sounding
+ * anymore, e.g. because its gate time is already over.
  *
  * @param note MIDI note to stop playing
  */
 void
 play_stop_note(uint8_t note)
 {
-    midi_msg_note_off(note, VELOCITY);
+    uint8_t sounding_note;
+
+    note_off_cancel(note);
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        sounding_note = note_sounding(note);
+        note_map[note >> 3] &= ~(1 << (note & 0x07));
+    }
+
+    if (sounding_note) {
+        note_off_send(note);
+    }
+}
+
+/**
+ * Print the playback step queue statistics via UART.
+ */
+void
+playback_print_stats(void)
+{
+    ring_print_stats(step_queue_string, &step_ring);
 }
 
 /**
@@ -264,5 +1521,5 @@ play_stop_note(uint8_t note)
 uint8_t
 playback_ongoing(void)
 {
-    return pressed;
+    return held != 0;
 }
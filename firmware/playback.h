@@ -20,32 +20,86 @@
 #define _PLAYBACK_H_
 #include <stdint.h>
 
-/* triad chord structure (plus octave) */
-typedef struct {
+/*
+ * chord tone list, in order of the PATTERN_* chord tone bits
+ *
+ * The chord tones refer to the positions within the chord voicing, lowest
+ * note first, so in an inversion the "root" is the lowest note played. The
+ * octave is the top of the voicing, including an added seventh below it.
+ */
+typedef enum {
     /* root note */
-    uint8_t root;
+    CHORD_ROOT,
     /* major (in chord I, V and IV) or minor (in chord vi) third */
-    uint8_t third;
+    CHORD_THIRD,
     /* perfect fifth */
-    uint8_t fifth;
+    CHORD_FIFTH,
     /* octave */
-    uint8_t octave;
-} chord_t;
+    CHORD_OCTAVE,
+    CHORD_TONES
+} chord_tone_t;
 
-/* playback mode callback function */
-typedef void (*playback_mode_callback_t)(chord_t *);
+/* max number of notes in a chord voicing, triad or seventh chord plus octave */
+#define CHORD_NOTES_MAX 5
 
-/* playback mode structure */
+/* chord voicing structure */
 typedef struct {
-    /* beat counter in 4/4 timing, i.e. 0..3 */
-    uint8_t count;
-    /* start callback, executed once on button press, skipped if NULL */
-    playback_mode_callback_t start;
-    /* cycle callback, executed periodically based on tempo, skipped if NULL */
-    playback_mode_callback_t cycle;
-    /* stop callback, executed once on button release, skipped if NULL */
-    playback_mode_callback_t stop;
-} playback_mode_t;
+    /* number of notes in the voicing */
+    uint8_t length;
+    /* MIDI notes of the voicing, lowest note first */
+    uint8_t notes[CHORD_NOTES_MAX];
+} chord_t;
+
+/* number of chord buttons, one per chord of the progression */
+#define PLAYBACK_CHORD_MAX 4
+
+/* chord release strategy list */
+typedef enum {
+    /* stop each note with its own note off */
+    PLAYBACK_RELEASE_NOTE_OFF,
+    /* hold the notes with the sustain pedal, release them all at once */
+    PLAYBACK_RELEASE_SUSTAIN,
+    PLAYBACK_RELEASE_MAX
+} playback_release_t;
+
+/* chord change quantization list */
+typedef enum {
+    /* change chords right away */
+    PLAYBACK_QUANTIZE_OFF,
+    /* change chords on the next beat, i.e. every quarter note */
+    PLAYBACK_QUANTIZE_BEAT,
+    /* change chords on the next bar */
+    PLAYBACK_QUANTIZE_BAR,
+    PLAYBACK_QUANTIZE_MAX
+} playback_quantize_t;
+
+/* chord voicing setting: inversion in the lower bits, flags on top */
+#define PLAYBACK_VOICING_INVERSION_MASK 0x03
+#define PLAYBACK_VOICING_LEAD           (1 << 6)
+#define PLAYBACK_VOICING_SEVENTH        (1 << 7)
+
+/* Playback gate length settings in percent */
+#define PLAYBACK_GATE_STEP      25
+#define PLAYBACK_GATE_DEFAULT   75
+#define PLAYBACK_GATE_MAX       100
+
+/*
+ * time in ms the last released chord keeps sounding, so pressing the next
+ * chord button right after it makes a legato chord change
+ */
+#define PLAYBACK_LEGATO_MS 40
+
+/*
+ * time in ms ahead of the next pattern step its MIDI messages are prepared,
+ * the clock then only has to release them to the USB transmit queue
+ */
+#define PLAYBACK_LOOKAHEAD_MS 10
+
+/* number of clock steps that can wait for playback_poll(), power of 2 */
+#define PLAYBACK_STEP_QUEUE_SIZE 4
+
+/* number of note-offs that can be scheduled at the same time */
+#define PLAYBACK_NOTE_OFF_SLOTS 8
 
 
 /**
@@ -53,6 +107,12 @@ typedef struct {
  * Called when one of the four chord buttons is pressed. The pressed chord
  * button number is given in the arg parameter.
  *
+ * Several chord buttons can be held at once. A chord pressed while others
+ * are held joins the ongoing pattern, starting only the notes no other held
+ * chord is playing already. With quantization enabled, the chord change
+ * waits for the next beat or bar after the time of the press, see
+ * button_event_time().
+ *
  * @param arg Pressed button number, given as pointer to uint8_t
  */
 void playback_button_press(void *arg);
@@ -62,21 +122,33 @@ void playback_button_press(void *arg);
  * Called when one of the four chord buttons is released. The released chord
  * button number is given in the arg parameter.
  *
+ * Only the notes no other held chord is playing are stopped, the playback
+ * itself stops once the last chord button is released. The last chord keeps
+ * sounding for PLAYBACK_LEGATO_MS though, and if another chord button gets
+ * pressed within that time, only the notes that differ between the two
+ * chords are stopped and started. With quantization enabled, it keeps on
+ * sounding until a latched chord change is applied.
+ *
  * @param arg Released button number, given as pointer to uint8_t
  */
 void playback_button_release(void *arg);
 
 /**
  * Start playing a given MIDI note.
- * Sends the note via USB as MIDI Note On message.
+ * Sends the note via USB as MIDI Note On message. If the current playback
+ * mode has a gate length set, the matching Note Off message is scheduled
+ * to be sent from the system tick interrupt once the gate time is over.
+ * While the sustain pedal is held down, the Note Off is sent right away.
  *
  * @param note MIDI note to start playing
+ * @param velocity MIDI note velocity
  */
-void play_start_note(uint8_t note);
+void play_start_note(uint8_t note, uint8_t velocity);
 
 /**
  * Stop playing a given MIDI note.
- * Sends the note via USB as MIDI Note Off message.
+ * Sends the note via USB as MIDI Note Off message, unless it isn't sounding
+ * anymore, e.g. because its gate time is already over.
  *
  * @param note MIDI note to stop playing
  */
@@ -84,13 +156,100 @@ void play_stop_note(uint8_t note);
 
 /**
  * Playback mode poll function.
- * If the cycle callback function is used by the playback mode, a timer is
- * started according to the currently selected playback tempo. This function
- * polls the status of the timer interrupt; if the cycle period is elapsed,
- * the cycle callback function is executed.
+ * Unless the playback mode's pattern only holds the chord, the clock
+ * advances the playback steps according to the current tempo. This function
+ * prepares the next step's MIDI messages once it is less than
+ * PLAYBACK_LOOKAHEAD_MS away, so the clock only needs to release them. If
+ * the cycle period elapsed without a prepared step, the pattern step for
+ * the current beat count is played right here instead.
  */
 void playback_poll(void);
 
+/**
+ * Initialize the playback.
+ * Reads the gate length settings of each playback mode, the chord voicing,
+ * the chord release, and the chord change quantization setting from the
+ * EEPROM.
+ */
+void playback_init(void);
+
+/**
+ * Select the next gate length for the current playback mode.
+ * Cycles through the gate lengths in PLAYBACK_GATE_STEP steps and stores
+ * the new value in the EEPROM.
+ */
+void playback_gate_next(void);
+
+/**
+ * Select the next chord inversion.
+ * Cycles through root position and all inversions of the current chord
+ * type, and stores the new value in the EEPROM.
+ */
+void playback_inversion_next(void);
+
+/**
+ * Toggle the added seventh for all chords.
+ * Stores the new value in the EEPROM.
+ */
+void playback_seventh_toggle(void);
+
+/**
+ * Toggle the voice leading between chord changes.
+ * When enabled, each chord is played in the inversion closest to the
+ * previous chord, instead of the selected one. Stores the new value in
+ * the EEPROM.
+ */
+void playback_voice_leading_toggle(void);
+
+/**
+ * Select the next chord release strategy.
+ * With the sustain strategy, every note gets its note off right after the
+ * note on while the sustain pedal (CC64) is held down, and a chord change
+ * or release only sends a single sustain pedal release. The note off
+ * strategy stops each note on its own for synths that ignore the sustain
+ * pedal. Stores the new value in the EEPROM.
+ */
+void playback_release_next(void);
+
+/**
+ * Select the next chord change quantization.
+ * With quantization enabled, a chord change while the pattern is playing
+ * is latched and applied on the next beat or bar, keeping the clock and the
+ * pattern in phase. Stores the new value in the EEPROM.
+ */
+void playback_quantize_next(void);
+
+/**
+ * Playback system tick handler.
+ * Counts down the scheduled note-offs and sends them once they are due.
+ * Called from the system tick interrupt handler.
+ */
+void playback_systick(void);
+
+/**
+ * Advance the playback by one cycle step based on the clock.
+ * In slave and master mode, the beat count keeps running even if no chord
+ * button is pressed, so a chord played at any time stays in phase with the
+ * clock. Called from the USB MIDI OUT handler in slave mode, and from the
+ * system tick interrupt in internal and master mode.
+ * The pattern steps are only played while a chord button is pressed. If
+ * the step's MIDI messages were prepared ahead of time, they are released
+ * to the USB transmit queue right here.
+ */
+void playback_clock_step(void);
+
+/**
+ * Reset the playback to the beginning of the bar.
+ * Called when the external MIDI clock is started, the next call to
+ * playback_clock_step() will then start over with the first beat.
+ */
+void playback_clock_start(void);
+
+/**
+ * Print the playback step queue statistics via UART.
+ */
+void playback_print_stats(void);
+
 /**
  * Get the current playback state.
  *
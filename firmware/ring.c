@@ -0,0 +1,113 @@
+/*
+ * 4chord MIDI - Single producer single consumer ring buffer
+ *
+ * Copyright (C) 2020 Sven Gregori <sven@craplab.fi>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/
+ *
+ */
+#include <stdint.h>
+#include <avr/pgmspace.h>
+#include "ring.h"
+#include "uart.h"
+
+static const char ring_pending_string[] PROGMEM = " pending, ";
+static const char ring_high_water_string[] PROGMEM = " max, ";
+static const char ring_drop_string[] PROGMEM = " dropped\r\n";
+
+
+/**
+ * Add an event to the ring buffer.
+ * Must only be called by the ring's single producer. If the ring is full,
+ * the event is dropped and counted.
+ *
+ * @param ring Ring buffer
+ * @param value Event to add
+ * @return 1 if the event was added, 0 if it was dropped
+ */
+uint8_t
+ring_put(ring_t *ring, uint8_t value)
+{
+    uint8_t head = ring->head;
+    uint8_t used = head - ring->tail;
+
+    if (used > ring->mask) {
+        ring->drops++;
+        return 0;
+    }
+
+    ring->buf[head & ring->mask] = value;
+    /* publish the event only after it is stored */
+    ring->head = head + 1;
+
+    if (++used > ring->high_water) {
+        ring->high_water = used;
+    }
+
+    return 1;
+}
+
+/**
+ * Take the oldest event from the ring buffer.
+ * Must only be called by the ring's single consumer.
+ *
+ * @param ring Ring buffer
+ * @param value Pointer to store the event in
+ * @return 1 if an event was taken, 0 if the ring was empty
+ */
+uint8_t
+ring_get(ring_t *ring, uint8_t *value)
+{
+    uint8_t tail = ring->tail;
+
+    if (tail == ring->head) {
+        return 0;
+    }
+
+    *value = ring->buf[tail & ring->mask];
+    /* free the slot only after it is read */
+    ring->tail = tail + 1;
+
+    return 1;
+}
+
+/**
+ * Get the number of events currently waiting in the ring buffer.
+ * @param ring Ring buffer
+ * @return Number of waiting events
+ */
+uint8_t
+ring_count(ring_t *ring)
+{
+    return ring->head - ring->tail;
+}
+
+/**
+ * Print the statistics of a ring buffer via UART.
+ * Shows the number of currently waiting events, the high-water mark, and
+ * the number of dropped events, prefixed by the given name.
+ *
+ * @param name PROGMEM string with the name of the ring buffer
+ * @param ring Ring buffer
+ */
+void
+ring_print_stats(const char *name, ring_t *ring)
+{
+    uart_print_pgm(name);
+    uart_putint(ring_count(ring), 1);
+    uart_print_pgm(ring_pending_string);
+    uart_putint(ring->high_water, 1);
+    uart_print_pgm(ring_high_water_string);
+    uart_putint(ring->drops, 1);
+    uart_print_pgm(ring_drop_string);
+}
@@ -0,0 +1,109 @@
+/*
+ * 4chord MIDI - Single producer single consumer ring buffer
+ *
+ * Copyright (C) 2020 Sven Gregori <sven@craplab.fi>
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/
+ *
+ */
+#ifndef _RING_H_
+#define _RING_H_
+#include <stdint.h>
+
+/*
+ * Ring buffer structure.
+ *
+ * Holds single byte events handed over from one producer to one consumer,
+ * typically from an interrupt handler to the main loop. The head index is
+ * only written by the producer, the tail index only by the consumer, so
+ * neither side needs to disable interrupts. Both indices are free running
+ * and masked on access, the buffer size must therefore be a power of 2, and
+ * at most 128.
+ */
+typedef struct {
+    /* event storage */
+    volatile uint8_t *buf;
+    /* buffer size minus one, masks the indices */
+    uint8_t mask;
+    /* write index, only written by the producer */
+    volatile uint8_t head;
+    /* read index, only written by the consumer */
+    volatile uint8_t tail;
+    /* highest number of events ever waiting in the ring at once */
+    volatile uint8_t high_water;
+    /* number of events dropped because the ring was full */
+    volatile uint16_t drops;
+} ring_t;
+
+/**
+ * Static initializer for a ring buffer using the given storage array.
+ * @param buffer Array of uint8_t, its size must be a power of 2
+ */
+#define RING_INIT(buffer) { .buf = (buffer), .mask = sizeof(buffer) - 1 }
+
+/**
+ * Get the buffer slot the next ring_put() call stores its event in.
+ * Lets the producer store additional data for the event in a separate
+ * array of the same size, before ring_put() hands both over. Only valid
+ * while the ring isn't full, otherwise the slot is still in use.
+ * @param ring Ring buffer
+ */
+#define ring_put_slot(ring) ((ring)->head & (ring)->mask)
+
+/**
+ * Get the buffer slot the next ring_get() call takes its event from.
+ * Lets the consumer read the additional data stored for the event with
+ * ring_put_slot(), before ring_get() releases the slot.
+ * @param ring Ring buffer
+ */
+#define ring_get_slot(ring) ((ring)->tail & (ring)->mask)
+
+/**
+ * Add an event to the ring buffer.
+ * Must only be called by the ring's single producer. If the ring is full,
+ * the event is dropped and counted.
+ *
+ * @param ring Ring buffer
+ * @param value Event to add
+ * @return 1 if the event was added, 0 if it was dropped
+ */
+uint8_t ring_put(ring_t *ring, uint8_t value);
+
+/**
+ * Take the oldest event from the ring buffer.
+ * Must only be called by the ring's single consumer.
+ *
+ * @param ring Ring buffer
+ * @param value Pointer to store the event in
+ * @return 1 if an event was taken, 0 if the ring was empty
+ */
+uint8_t ring_get(ring_t *ring, uint8_t *value);
+
+/**
+ * Get the number of events currently waiting in the ring buffer.
+ * @param ring Ring buffer
+ * @return Number of waiting events
+ */
+uint8_t ring_count(ring_t *ring);
+
+/**
+ * Print the statistics of a ring buffer via UART.
+ * Shows the number of currently waiting events, the high-water mark, and
+ * the number of dropped events, prefixed by the given name.
+ *
+ * @param name PROGMEM string with the name of the ring buffer
+ * @param ring Ring buffer
+ */
+void ring_print_stats(const char *name, ring_t *ring);
+
+#endif
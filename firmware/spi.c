@@ -18,21 +18,15 @@
  */
 #include <stdint.h>
 #include <avr/io.h>
+#include <avr/pgmspace.h>
 #include "config.h"
-
-/* set SPI chip select pin high */
-#define spi_cs_high()   do { SPI_CS_PORT |=  (1 << SPI_CS_PIN); } while (0)
-/* set SPI chip select pin low */
-#define spi_cs_low()    do { SPI_CS_PORT &= ~(1 << SPI_CS_PIN); } while (0)
-/* set SPI data/command pin high */
-#define spi_dc_high()   do { SPI_DC_PORT |=  (1 << SPI_DC_PIN); } while (0)
-/* set SPI data/command pin low */
-#define spi_dc_low()    do { SPI_DC_PORT &= ~(1 << SPI_DC_PIN); } while (0)
+#include "spi.h"
 
 /**
  * Initialize SPI.
  *
- * SPI is set up as controller, Mode 0, F_CPU/4 clock speed, MSB first
+ * SPI is set up as controller, Mode 0, F_CPU/4 clock speed (F_CPU/2 if
+ * SPI_DOUBLE_SPEED is enabled in config.h), MSB first
  */
 void
 spi_init(void)
@@ -41,43 +35,158 @@ spi_init(void)
     SPCR  = (1 << SPE) | (1 << MSTR);
     /* Mode 0 */
     SPCR |= (0 << CPOL) | (0 << CPHA);
-    /* Clock F_CPU/4 */
+    /* Clock F_CPU/4, or F_CPU/2 with double speed */
     SPCR |= (0 << SPR0) | (0 << SPR1);
+    SPSR  = (SPI_DOUBLE_SPEED << SPI2X);
     /* Data direction MSB first */
     SPCR |= (0 << DORD);
 }
 
 /**
- * Send SPI command byte to LCD.
- * @param command Command to send via SPI
+ * Begin an SPI burst transfer.
+ * Selects the LCD, which then stays selected for all spi_write_*() calls
+ * until spi_end() is called.
  */
 void
-spi_send_command(uint8_t command) {
+spi_begin(void)
+{
     spi_cs_low();
-    spi_dc_low();
+}
 
+/**
+ * End an SPI burst transfer.
+ * Deselects the LCD again. All spi_write_*() functions return only after
+ * their last byte is completely shifted out, so there's nothing to wait for.
+ */
+void
+spi_end(void)
+{
+    spi_cs_high();
+}
+
+/**
+ * Write a command byte within an SPI burst transfer.
+ * @param command Command to send via SPI
+ */
+void
+spi_write_command(uint8_t command)
+{
+    spi_dc_low();
     SPDR = command;
-    while (!(SPSR & (1 << SPIF))) {
-        /* wait */
-    }
+    spi_wait_ready();
+}
 
-    spi_cs_high();
+/**
+ * Write a data byte within an SPI burst transfer.
+ * @param data Data to send via SPI
+ */
+void
+spi_write_byte(uint8_t data)
+{
+    spi_dc_high();
+    SPDR = data;
+    spi_wait_ready();
 }
 
 /**
- * Send SPI data byte to LCD.
+ * Write a block of data from RAM within an SPI burst transfer.
+ * The next byte is fetched while the current one is shifted out, so the
+ * only thing left to do once the transfer is done is writing it to SPDR.
+ *
  * @param data Data to send via SPI
+ * @param len Number of bytes to send
  */
 void
-spi_send_data(uint8_t data) {
-    spi_cs_low();
+spi_write_data(const uint8_t *data, uint16_t len)
+{
+    uint8_t next;
+
+    if (len == 0) {
+        return;
+    }
+
+    spi_dc_high();
+    next = *data++;
+    while (--len) {
+        SPDR = next;
+        next = *data++;
+        spi_wait_ready();
+    }
+    SPDR = next;
+    spi_wait_ready();
+}
+
+/**
+ * Write a block of data from PROGMEM within an SPI burst transfer.
+ * Same as spi_write_data(), reading the next byte from flash during the
+ * current transfer.
+ *
+ * @param data PROGMEM data to send via SPI
+ * @param len Number of bytes to send
+ */
+void
+spi_write_data_pgm(const uint8_t *data, uint16_t len)
+{
+    uint8_t next;
+
+    if (len == 0) {
+        return;
+    }
+
     spi_dc_high();
+    next = pgm_read_byte(data++);
+    while (--len) {
+        SPDR = next;
+        next = pgm_read_byte(data++);
+        spi_wait_ready();
+    }
+    SPDR = next;
+    spi_wait_ready();
+}
 
-    SPDR = data;
-    while (!(SPSR & (1 << SPIF))) {
-        /* wait */
+/**
+ * Write the same data byte a given number of times within an SPI burst
+ * transfer.
+ *
+ * @param value Data to send via SPI
+ * @param len Number of times to send it
+ */
+void
+spi_write_fill(uint8_t value, uint16_t len)
+{
+    spi_dc_high();
+    while (len--) {
+        SPDR = value;
+        spi_wait_ready();
     }
+}
 
-    spi_cs_high();
+/**
+ * Send SPI command byte to LCD.
+ * Single byte shortcut for a spi_begin(), spi_write_command(), spi_end()
+ * burst.
+ *
+ * @param command Command to send via SPI
+ */
+void
+spi_send_command(uint8_t command)
+{
+    spi_begin();
+    spi_write_command(command);
+    spi_end();
 }
 
+/**
+ * Send SPI data byte to LCD.
+ * Single byte shortcut for a spi_begin(), spi_write_byte(), spi_end()
+ * burst.
+ *
+ * @param data Data to send via SPI
+ */
+void
+spi_send_data(uint8_t data)
+{
+    spi_begin();
+    spi_write_byte(data);
+    spi_end();
+}
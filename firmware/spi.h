@@ -19,24 +19,111 @@
 #ifndef _SPI_H_
 #define _SPI_H_
 #include <stdint.h>
+#include <avr/io.h>
+#include "config.h"
+
+/* set SPI chip select pin high */
+#define spi_cs_high()   do { SPI_CS_PORT |=  (1 << SPI_CS_PIN); } while (0)
+/* set SPI chip select pin low */
+#define spi_cs_low()    do { SPI_CS_PORT &= ~(1 << SPI_CS_PIN); } while (0)
+/* set SPI data/command pin high */
+#define spi_dc_high()   do { SPI_DC_PORT |=  (1 << SPI_DC_PIN); } while (0)
+/* set SPI data/command pin low */
+#define spi_dc_low()    do { SPI_DC_PORT &= ~(1 << SPI_DC_PIN); } while (0)
+
+/*
+ * Non-blocking transfers
+ *
+ * spi_put_command() and spi_put_data() start sending a byte and return
+ * right away, the caller has to check with spi_wait_ready() that the
+ * previous byte is shifted out before putting the next one in place.
+ * The LCD has to be selected with spi_cs_low() beforehand, and the
+ * blocking functions below must not be used while such a transfer is
+ * ongoing.
+ */
+/*
+ * wait for the current SPI transfer to complete
+ * Reading SPSR with SPIF set followed by the SPDR access in the next
+ * transfer clears the flag again.
+ */
+#define spi_wait_ready() do { while (!(SPSR & (1 << SPIF))) { /* wait */ } } while (0)
+/* start sending a command byte without waiting for it */
+#define spi_put_command(command) do { spi_dc_low();  SPDR = (command); } while (0)
+/* start sending a data byte without waiting for it */
+#define spi_put_data(data)       do { spi_dc_high(); SPDR = (data); } while (0)
 
 /**
  * Initialize SPI.
  *
- * SPI is set up as controller, Mode 0, F_CPU/4 clock speed, MSB first
+ * SPI is set up as controller, Mode 0, F_CPU/4 clock speed (F_CPU/2 if
+ * SPI_DOUBLE_SPEED is enabled in config.h), MSB first
  */
 void spi_init(void);
 
 /**
  * Send SPI command.
+ * Single byte shortcut for a spi_begin(), spi_write_command(), spi_end()
+ * burst.
+ *
  * @param command Command to send via SPI
  */
 void spi_send_command(uint8_t command);
 
 /**
  * Send SPI data.
+ * Single byte shortcut for a spi_begin(), spi_write_byte(), spi_end()
+ * burst.
+ *
  * @param data Data to send via SPI
  */
 void spi_send_data(uint8_t data);
 
+/**
+ * Begin an SPI burst transfer.
+ * Selects the LCD, which then stays selected for all spi_write_*() calls
+ * until spi_end() is called.
+ */
+void spi_begin(void);
+
+/**
+ * End an SPI burst transfer.
+ * Deselects the LCD again.
+ */
+void spi_end(void);
+
+/**
+ * Write a command byte within an SPI burst transfer.
+ * @param command Command to send via SPI
+ */
+void spi_write_command(uint8_t command);
+
+/**
+ * Write a data byte within an SPI burst transfer.
+ * @param data Data to send via SPI
+ */
+void spi_write_byte(uint8_t data);
+
+/**
+ * Write a block of data from RAM within an SPI burst transfer.
+ * @param data Data to send via SPI
+ * @param len Number of bytes to send
+ */
+void spi_write_data(const uint8_t *data, uint16_t len);
+
+/**
+ * Write a block of data from PROGMEM within an SPI burst transfer.
+ * @param data PROGMEM data to send via SPI
+ * @param len Number of bytes to send
+ */
+void spi_write_data_pgm(const uint8_t *data, uint16_t len);
+
+/**
+ * Write the same data byte a given number of times within an SPI burst
+ * transfer.
+ *
+ * @param value Data to send via SPI
+ * @param len Number of times to send it
+ */
+void spi_write_fill(uint8_t value, uint16_t len);
+
 #endif
@@ -20,10 +20,48 @@
 #include <stdint.h>
 #include <avr/io.h>
 #include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include <util/atomic.h>
+#include "buttons.h"
+#include "clock.h"
+#include "playback.h"
+#include "ring.h"
 #include "timer.h"
+#include "uart.h"
 
-/* callback function to call on timer interrupt */
-static timer_callback_t timer1_callback;
+static const char expiry_queue_string[] PROGMEM = "Timer queue: ";
+
+/* software timer structure */
+typedef struct {
+    /* system ticks until the timer expires next, 0 if the timer is stopped */
+    uint16_t remaining;
+    /* system ticks between periodic expiries, 0 for one-shot timers */
+    uint16_t period;
+    /*
+     * start count of the timer, only written in the main loop. Expiries are
+     * tagged with it, so the ones queued before a restart or stop are
+     * recognized as stale and discarded.
+     */
+    uint8_t generation;
+    /* callback function executed in timer_poll() */
+    timer_callback_t callback;
+} soft_timer_t;
+
+/* software timers, counted down in the system tick interrupt */
+static volatile soft_timer_t soft_timers[TIMER_MAX];
+
+/*
+ * Expired software timers waiting for timer_poll(), each event holds the
+ * timer id in the lower nibble and its generation in the upper nibble.
+ */
+static uint8_t expiry_buf[TIMER_QUEUE_SIZE];
+static ring_t expiry_ring = RING_INIT(expiry_buf);
+#define EXPIRY_ID_MASK          0x0f
+#define EXPIRY_GENERATION_MASK  0x0f
+#define EXPIRY_GENERATION_SHIFT 4
+
+/* system tick counter, increased in timer2 compare match interrupt */
+static volatile uint16_t systick;
 
 
 /**
@@ -42,43 +80,171 @@ timer0_init_pwm(void)
 
 
 /**
- * Start 16bit timer in given interval, executing given callback function
- * on compare match.
- * Note, the prescaler is set to 1024.
+ * Set up 8bit timer2 as free running system tick.
+ * Timer2 runs in CTC mode and triggers a compare match interrupt
+ * SYSTICK_FREQ times per second, counting up the system tick.
+ */
+void
+timer2_init_systick(void)
+{
+    TCNT2  = 0x00; /* reset to zero */
+    OCR2A  = SYSTICK_COUNTS - 1; /* set compare match value */
+    TIMSK2 = (1 << OCIE2A); /* enable compare match interrupt */
+    TCCR2A = (1 << WGM21); /* CTC mode, no output ports */
+    TCCR2B = (1 << CS22); /* prescaler 64 */
+}
+
+/**
+ * Get the current system tick count.
+ * The system tick is increased SYSTICK_FREQ times per second and will
+ * simply wrap around when it overflows.
+ *
+ * @return Current system tick count
+ */
+uint16_t
+timer_get_systick(void)
+{
+    uint16_t ticks;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        ticks = systick;
+    }
+
+    return ticks;
+}
+
+/**
+ * Get a high resolution timestamp.
+ * Combines the system tick and the timer2 counter value to a timestamp
+ * with the resolution of a single timer2 count (64 / F_CPU seconds).
+ * Use TIMESTAMP_TO_US() to convert the difference between two timestamps
+ * to microseconds. Note, the timestamp wraps around roughly every 350ms.
+ *
+ * @return Current timestamp in timer2 counts
+ */
+uint16_t
+timer_get_timestamp(void)
+{
+    uint16_t ticks;
+    uint8_t counts;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        ticks  = systick;
+        counts = TCNT2;
+        if ((TIFR2 & (1 << OCF2A)) && counts < (SYSTICK_COUNTS >> 1)) {
+            /* counter wrapped, but the interrupt didn't get to run yet */
+            ticks++;
+        }
+    }
+
+    return ticks * SYSTICK_COUNTS + counts;
+}
+
+/**
+ * Start a software timer.
+ * The timer expires after the given delay, and if the given period isn't
+ * zero, keeps on expiring periodically after that. Starting an already
+ * running timer restarts it with the new values. Use TIMER_MS() to convert
+ * milliseconds to system ticks.
+ *
+ * The callback function is not executed in interrupt context, but from
+ * within timer_poll() in the main loop.
+ *
+ * @param id Software timer to start
+ * @param delay Number of system ticks until the timer expires first
+ * @param period Number of system ticks between each following expiry, 0 for one-shot
+ * @param callback Callback function executed when the timer expires
+ */
+void
+timer_start(timer_id_t id, uint16_t delay, uint16_t period, timer_callback_t callback)
+{
+    volatile soft_timer_t *timer = &soft_timers[id];
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        timer->remaining = (delay > 0) ? delay : 1;
+        timer->period = period;
+        timer->generation++;
+        timer->callback = callback;
+    }
+}
+
+/**
+ * Stop a software timer.
+ * Also discards pending expiries that weren't handled by timer_poll() yet.
  *
- * @param value Timer count value
- * @param callback Callback function executed when timer compare interrupt hits
+ * @param id Software timer to stop
+ */
+void
+timer_stop(timer_id_t id)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        soft_timers[id].remaining = 0;
+    }
+    soft_timers[id].generation++;
+}
+
+/**
+ * Software timer poll function.
+ * Executes the callback function of every software timer that expired
+ * since the last call, once for each queued expiry, so a periodic timer
+ * doesn't lose expiries while the main loop is busy. Call this from the
+ * main loop.
  */
 void
-timer1_start(uint16_t value, timer_callback_t callback)
+timer_poll(void)
 {
-    timer1_callback = callback;
-    TCNT1  = 0x00; /* reset to zero */
-    OCR1A  = value; /* set compare match value */
-    TIMSK1 = (1 << OCIE1A); /* enable compare match interrupt */
-    TCCR1A = 0x00; /* no output ports, no PWM mode - value never change */
-    TCCR1B = (1 << WGM12) | (1 << CS12) | (1 << CS10); /* CTC mode, prescaler 1024 */
-    TCCR1C = 0x00;
+    volatile soft_timer_t *timer;
+    uint8_t event;
+
+    while (ring_get(&expiry_ring, &event)) {
+        timer = &soft_timers[event & EXPIRY_ID_MASK];
+
+        if ((timer->generation & EXPIRY_GENERATION_MASK) == (event >> EXPIRY_GENERATION_SHIFT)) {
+            timer->callback();
+        }
+    }
 }
 
 /**
- * Stop 16bit timer.
+ * Print the software timer expiry queue statistics via UART.
  */
 void
-timer1_stop(void)
+timer_print_stats(void)
 {
-    TCCR1B = 0x00; /* no clock source */
-    timer1_callback = NULL;
+    ring_print_stats(expiry_queue_string, &expiry_ring);
 }
 
 /**
- * Timer intterupt handler.
- * Call timer1_callback is it is set.
+ * Count down all running software timers by one system tick.
+ * Called from the system tick interrupt handler.
  */
-SIGNAL(TIMER1_COMPA_vect)
+static inline void
+soft_timers_tick(void)
 {
-    if (timer1_callback != NULL) {
-        timer1_callback();
+    volatile soft_timer_t *timer;
+    uint8_t id;
+
+    for (id = 0; id < TIMER_MAX; id++) {
+        timer = &soft_timers[id];
+        if (timer->remaining > 0 && --timer->remaining == 0) {
+            timer->remaining = timer->period;
+            ring_put(&expiry_ring, id | (timer->generation << EXPIRY_GENERATION_SHIFT));
+        }
     }
 }
 
+/**
+ * System tick interrupt handler.
+ * Declared non-blocking so V-USB's own interrupt is never delayed by it.
+ * Also drives the MIDI clock generation, the scheduled note-offs, the
+ * button debouncing, and the software timers.
+ */
+ISR(TIMER2_COMPA_vect, ISR_NOBLOCK)
+{
+    systick++;
+    clock_systick();
+    playback_systick();
+    buttons_systick();
+    soft_timers_tick();
+}
+
@@ -20,10 +20,29 @@
 #define _TIMER_H_
 #include <stdint.h>
 
-/* number of clock cycles in one timer cycle with prescaler 1024 */
-#define TICKS_PER_CYCLE (F_CPU >> 10)
+/* timer2 system tick frequency in Hz */
+#define SYSTICK_FREQ 2500
 
-/* timer interrupt handler callback function */
+/* number of timer2 counts per system tick with prescaler 64 */
+#define SYSTICK_COUNTS ((F_CPU >> 6) / SYSTICK_FREQ)
+
+/* convert a timestamp from timer_get_timestamp() to microseconds */
+#define TIMESTAMP_TO_US(ts) (((uint32_t) (ts) * 64000) / (F_CPU / 1000))
+
+/* convert milliseconds to system ticks, e.g. for software timer delays */
+#define TIMER_MS(ms) ((uint16_t) (((uint32_t) (ms) * SYSTICK_FREQ) / 1000))
+
+/* software timer list, each one can run independently of all others */
+typedef enum {
+    /* chord release delay for legato chord changes */
+    TIMER_LEGATO,
+    TIMER_MAX
+} timer_id_t;
+
+/* number of expiries the software timer queue can hold, power of 2 */
+#define TIMER_QUEUE_SIZE 8
+
+/* software timer callback function */
 typedef void (*timer_callback_t)(void);
 
 
@@ -45,18 +64,69 @@ void timer0_init_pwm(void);
 #define timer0_set_pwm(val) do { OCR0B = val; } while (0)
 
 /**
- * Start 16bit timer in given interval, executing given callback function
- * on compare match.
- * Note, the prescaler is set to 1024.
+ * Set up 8bit timer2 as free running system tick.
+ * Timer2 runs in CTC mode and triggers a compare match interrupt
+ * SYSTICK_FREQ times per second, counting up the system tick.
+ */
+void timer2_init_systick(void);
+
+/**
+ * Get the current system tick count.
+ * The system tick is increased SYSTICK_FREQ times per second and will
+ * simply wrap around when it overflows.
+ *
+ * @return Current system tick count
+ */
+uint16_t timer_get_systick(void);
+
+/**
+ * Get a high resolution timestamp.
+ * Combines the system tick and the timer2 counter value to a timestamp
+ * with the resolution of a single timer2 count (64 / F_CPU seconds).
+ * Use TIMESTAMP_TO_US() to convert the difference between two timestamps
+ * to microseconds. Note, the timestamp wraps around roughly every 350ms.
  *
- * @param value Timer count value
- * @param callback Callback function executed when timer compare interrupt hits
+ * @return Current timestamp in timer2 counts
+ */
+uint16_t timer_get_timestamp(void);
+
+/**
+ * Start a software timer.
+ * The timer expires after the given delay, and if the given period isn't
+ * zero, keeps on expiring periodically after that. Starting an already
+ * running timer restarts it with the new values. Use TIMER_MS() to convert
+ * milliseconds to system ticks.
+ *
+ * The callback function is not executed in interrupt context, but from
+ * within timer_poll() in the main loop.
+ *
+ * @param id Software timer to start
+ * @param delay Number of system ticks until the timer expires first
+ * @param period Number of system ticks between each following expiry, 0 for one-shot
+ * @param callback Callback function executed when the timer expires
+ */
+void timer_start(timer_id_t id, uint16_t delay, uint16_t period, timer_callback_t callback);
+
+/**
+ * Stop a software timer.
+ * Also discards pending expiries that weren't handled by timer_poll() yet.
+ *
+ * @param id Software timer to stop
+ */
+void timer_stop(timer_id_t id);
+
+/**
+ * Software timer poll function.
+ * Executes the callback function of every software timer that expired
+ * since the last call, once for each queued expiry, so a periodic timer
+ * doesn't lose expiries while the main loop is busy. Call this from the
+ * main loop.
  */
-void timer1_start(uint16_t value, timer_callback_t callback);
+void timer_poll(void);
 
 /**
- * Stop 16bit timer.
+ * Print the software timer expiry queue statistics via UART.
  */
-void timer1_stop(void);
+void timer_print_stats(void);
 
 #endif
@@ -19,21 +19,25 @@
 #include <avr/io.h>
 #include <avr/interrupt.h>
 #include <avr/pgmspace.h>
+#include "ring.h"
 #include "uart.h"
 
-/* internal receive buffer */
-static volatile char uart_inbuf;
+static const char rx_queue_string[] PROGMEM = "UART RX queue: ";
+
+/* internal receive queue, filled by the receive interrupt handler */
+static uint8_t rx_buf[UART_RX_QUEUE_SIZE];
+static ring_t rx_ring = RING_INIT(rx_buf);
 
 /**
  * UART receive interrupt handler.
- * Reads the input register and stores the data in the internal buffer.
+ * Reads the input register and adds the data to the internal receive queue.
  */
 SIGNAL(USART_RX_vect)
 {
     char c;
 
     c = uart_getchar();
-    uart_inbuf = c;
+    ring_put(&rx_ring, c);
 }
 
 
@@ -224,24 +228,30 @@ uart_getchar(void)
 }
 
 /**
- * Get the internal buffer for received characters.
- * The receive interrupt handler is filling the buffer.
+ * Get the next character from the internal receive queue.
+ * The receive interrupt handler is filling the queue, every received
+ * character is returned exactly once, in order of arrival.
  * If no new data was received, 0 is returned.
  *
- * @return Last received character, 0 if no data was received.
+ * @return Next received character, 0 if no data was received.
  */
 char
 uart_get_inbuf(void)
 {
-    return uart_inbuf;
+    uint8_t c;
+
+    if (ring_get(&rx_ring, &c)) {
+        return c;
+    }
+    return 0;
 }
 
 /**
- * Reset the internal receive buffer.
+ * Print the receive queue statistics via UART.
  */
 void
-uart_reset_inbuf(void)
+uart_print_stats(void)
 {
-    uart_inbuf = 0;
+    ring_print_stats(rx_queue_string, &rx_ring);
 }
 
@@ -26,6 +26,9 @@
 #define UART_BRATE_38400_12MHZ  19
 #define UART_BRATE_57600_12MHZ  12
 
+/* number of received characters the receive queue can hold, power of 2 */
+#define UART_RX_QUEUE_SIZE 16
+
 /**
  * Initialize UART with given baud rate value.
  * See list of UART_BRATE_* defines for some predefined baud rate values.
@@ -92,17 +95,18 @@ void uart_putint(int32_t number, int8_t digits);
 char uart_getchar(void);
 
 /**
- * Get the internal buffer for received characters.
- * The receive interrupt handler is filling the buffer.
+ * Get the next character from the internal receive queue.
+ * The receive interrupt handler is filling the queue, every received
+ * character is returned exactly once, in order of arrival.
  * If no new data was received, 0 is returned.
  *
- * @return Last received character, 0 if no data was received.
+ * @return Next received character, 0 if no data was received.
  */
 char uart_get_inbuf(void);
 
 /**
- * Reset the internal receive buffer.
+ * Print the receive queue statistics via UART.
  */
-void uart_reset_inbuf(void);
+void uart_print_stats(void);
 
 #endif
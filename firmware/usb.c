@@ -18,12 +18,117 @@
  */
 #include <string.h>
 #include <stdint.h>
+#include <avr/eeprom.h>
+#include <util/atomic.h>
 #include <util/delay.h>
+#include "clock.h"
+#include "eeprom.h"
+#include "timer.h"
 #include "uart.h"
+#include "usb.h"
 #include "usbconfig.h"
 #include "usbdrv/usbdrv.h"
 
 static const char send_failed_string[] PROGMEM = "USB send failed\r\n";
+static const char queue_string[] PROGMEM = "USB MIDI queue: ";
+static const char queue_pending_string[] PROGMEM = " pending, ";
+static const char queue_overflow_string[] PROGMEM = " overflows, ";
+static const char queue_drop_string[] PROGMEM = " dropped\r\n";
+static const char irq_queue_string[] PROGMEM = "USB MIDI real-time queue: ";
+static const char interval_string[] PROGMEM = "USB poll interval: ";
+static const char interval_ms_string[] PROGMEM = "ms, reconnecting\r\n";
+static const char latency_on_string[] PROGMEM = "Latency measurement on\r\n";
+static const char latency_off_string[] PROGMEM = "Latency measurement off\r\n";
+static const char latency_string[] PROGMEM = "USB MIDI latency: ";
+static const char latency_min_string[] PROGMEM = " transfers, min ";
+static const char latency_avg_string[] PROGMEM = "us, avg ";
+static const char latency_max_string[] PROGMEM = "us, max ";
+static const char latency_us_string[] PROGMEM = "us\r\n";
+
+/* list of selectable interrupt endpoint poll intervals in ms */
+static const uint8_t poll_intervals[] = {1, 2, 4, 8, 10};
+
+/*
+ * USB MIDI transmit queue.
+ *
+ * Ring buffer of USB MIDI event packets waiting to be sent to the host.
+ * MIDI messages are added to the head of the queue by the send function,
+ * and taken from the tail in usb_midi_poll() whenever the interrupt IN
+ * endpoint is ready to take more data. Both indices are free running and
+ * masked on access, so the queue is empty if head and tail are the same,
+ * and full if they are USB_MIDI_QUEUE_SIZE apart.
+ *
+ * Messages are added from both the main loop and interrupt context, always
+ * with interrupts disabled, so all note messages go out in the order they
+ * were sent in.
+ */
+static uint8_t tx_queue[USB_MIDI_QUEUE_SIZE][USB_MIDI_PACKET_SIZE];
+/* queue write index, next packet is stored here */
+static volatile uint8_t tx_head;
+/* queue read index, next packet is sent from here */
+static uint8_t tx_tail;
+/* queue overflow status, set while messages are dropped */
+static uint8_t tx_overflowed;
+/* number of times the queue ran full */
+static uint16_t tx_overflows;
+/* number of packets dropped because the queue was full */
+static uint16_t tx_drops;
+/* timestamps of when each packet was added to the queue */
+static uint16_t tx_stamps[USB_MIDI_QUEUE_SIZE];
+
+/*
+ * Transmit queue for MIDI System Real-Time messages. MIDI allows them
+ * anywhere in the message stream, so they are sent ahead of the regular
+ * transmit queue to keep the clock jitter low. Messages are added with
+ * interrupts disabled, the tail index is only written by the consumer
+ * (main loop).
+ */
+static volatile uint8_t irq_queue[USB_MIDI_IRQ_QUEUE_SIZE][USB_MIDI_PACKET_SIZE];
+/* real-time queue write index, only written with interrupts disabled */
+static volatile uint8_t irq_head;
+/* real-time queue read index, only written in main loop */
+static volatile uint8_t irq_tail;
+/* number of packets dropped because the real-time queue was full */
+static volatile uint16_t irq_drops;
+
+/*
+ * Stage queue for messages prepared ahead of time, e.g. the next playback
+ * step. Packets are added in the main loop, but only move on to the
+ * transmit queue once they are committed from interrupt context, so the
+ * moment they hit the wire doesn't depend on how long the main loop took
+ * to build them.
+ */
+static uint8_t stage_queue[USB_MIDI_STAGE_SIZE][USB_MIDI_PACKET_SIZE];
+/* stage queue write index, only written in main loop */
+static volatile uint8_t stage_head;
+/* stage queue read index, only written on commit */
+static volatile uint8_t stage_tail;
+
+/*
+ * Latency measurement data.
+ *
+ * If enabled, the time between adding a packet to the transmit queue and
+ * the host actually polling it from the interrupt endpoint is measured for
+ * the first packet of every transfer. The host poll itself is noticed in
+ * usb_midi_poll() when the endpoint becomes ready again after a transfer.
+ */
+static struct {
+    /* measurement enabled status */
+    uint8_t enabled;
+    /* set while a measured transfer is waiting for the host to poll it */
+    uint8_t in_flight;
+    /* queue timestamp of the first packet of the in-flight transfer */
+    uint16_t stamp;
+    /* number of measured transfers */
+    uint16_t count;
+    /* shortest, longest, and sum of all measured latencies */
+    uint16_t min;
+    uint16_t max;
+    uint32_t sum;
+} latency;
+
+/* poll interval of the interrupt endpoint in ms, set up in usb_init() */
+static uint8_t poll_interval;
 
 /*
  * USB MIDI device and configuration descriptor setup
@@ -33,7 +138,9 @@ static const char send_failed_string[] PROGMEM = "USB send failed\r\n";
  *
  * The descriptor definition is based and taken from the example found in
  * the above mentioned document, Appendix B.1. and was adjusted to provide
- * one interface (MIDI IN Jack) with one bulk endpoint.
+ * one embedded MIDI IN Jack fed by an OUT endpoint (MIDI data from the host,
+ * used for MIDI clock sync), and one embedded MIDI OUT Jack feeding an IN
+ * endpoint (MIDI data to the host, i.e. everything that's played).
  */
 
 /*
@@ -65,7 +172,7 @@ const uint8_t usb_midi_config_descriptor[] PROGMEM = {
 /* B.2   Configuration Descriptor */
     0x09,               /* [1] size of this descriptor in bytes (9)         */
     USBDESCR_CONFIG,    /* [1] descriptor type (CONFIGURATION)              */
-    0x3f, 0x00,         /* [2] total length of descriptor in bytes (63)     */
+    0x56, 0x00,         /* [2] total length of descriptor in bytes (86)     */
     0x02,               /* [1] number of interfaces (2)                     */
     0x01,               /* [1] ID of this configuration (1)                 */
     0x00,               /* [1] configuration, unused                        */
@@ -99,7 +206,7 @@ const uint8_t usb_midi_config_descriptor[] PROGMEM = {
     USBDESCR_INTERFACE, /* [1] descriptor type (INTERFACE)                  */
     0x01,               /* [1] index of this interface (1)                  */
     0x00,               /* [1] index of this alternate setting (0)          */
-    0x01,               /* [1] number of endpoints to follow (1)            */
+    0x02,               /* [1] number of endpoints to follow (2)            */
     0x01,               /* [1] interface class (AUDIO)                      */
     0x03,               /* [1] interface sublass (MIDSTREAMING)             */
     0x00,               /* [1] interface protocol, unused                   */
@@ -110,7 +217,7 @@ const uint8_t usb_midi_config_descriptor[] PROGMEM = {
     0x24,               /* [1] descriptor type (CS_INTERFACE)               */
     0x01,               /* [1] header subtype                               */
     0x00, 0x01,         /* [2] revision of class specification (1.0)        */
-    0x41, 0x00,         /* [2] total size of class spec descriptor (65)     */
+    0x32, 0x00,         /* [2] total size of class spec descriptor (50)     */
 
 /* B.4.3 MIDI IN Jack Descriptor Embedded */
     0x06,               /* [1] size of this descriptor in bytes (6)         */
@@ -120,6 +227,35 @@ const uint8_t usb_midi_config_descriptor[] PROGMEM = {
     0x01,               /* [1] jack ID (1)                                  */
     0x00,               /* [1] unused */
 
+/* B.4.4 MIDI OUT Jack Descriptor Embedded */
+    0x09,               /* [1] size of this descriptor in bytes (9)         */
+    0x24,               /* [1] descriptor type (CS_INTERFACE)               */
+    0x03,               /* [1] header subtype (MIDI_OUT_JACK)               */
+    0x01,               /* [1] jack type (EMBEDDED)                         */
+    0x02,               /* [1] jack ID (2)                                  */
+    0x01,               /* [1] number of input pins (1)                     */
+    0x01,               /* [1] id of the entity connected to input pin (1)  */
+    0x01,               /* [1] output pin number of that entity (1)         */
+    0x00,               /* [1] unused */
+
+/* B.5   Bulk OUT Endpoint Descriptors */
+/* B.5.1 Standard Bulk OUT Endpoint Descriptor */
+    0x09,               /* [1] size of this descriptor in bytes (9)         */
+    USBDESCR_ENDPOINT,  /* [1] descriptor type (ENDPOINT)                   */
+    0x01,               /* [1] endpoint address (OUT 1)                     */
+    0x03,               /* [1] attribute (interrupt endpoint)               */
+    0x08, 0x00,         /* [2] max packet size (8)                          */
+    USB_CFG_INTR_POLL_INTERVAL, /* [1] interval in ms, adjusted at runtime */
+    0x00,               /* [1] refresh                                      */
+    0x00,               /* [1] sync address                                 */
+
+/* B.5.2 Class-specific MS Bulk OUT Endpoint Descriptor */
+    0x05,               /* [1] size of this descriptor in bytes (5)         */
+    0x25,               /* [1] descriptor type (CS_ENDPOINT)                */
+    0x01,               /* [1] descriptor subtype (MS_GENERAL)              */
+    0x01,               /* [1] number of embedded MIDI IN jacks (1)         */
+    0x01,               /* [1] id of the embedded MIDI IN jack (1)          */
+
 /* B.6   Bulk IN Endpoint Descriptors */
 /* B.6.1 Standard Bulk IN Endpoint Descriptor */
     0x09,               /* [1] size of this descriptor in bytes (9)         */
@@ -127,7 +263,7 @@ const uint8_t usb_midi_config_descriptor[] PROGMEM = {
     0x81,               /* [1] endpoint address (IN 1)                      */
     0x03,               /* [1] attribute (interrupt endpoint)               */
     0x08, 0x00,         /* [2] max packet size (8)                          */
-    0x0a,               /* [1] interval in ms (10)                          */
+    USB_CFG_INTR_POLL_INTERVAL, /* [1] interval in ms, adjusted at runtime */
     0x00,               /* [1] refresh                                      */
     0x00,               /* [1] sync address                                 */
 
@@ -136,10 +272,18 @@ const uint8_t usb_midi_config_descriptor[] PROGMEM = {
     0x25,               /* [1] descriptor type (CS_ENDPOINT)                */
     0x01,               /* [1] descriptor subtype (MS_GENERAL)              */
     0x01,               /* [1] number of embedded MIDI OUT jacks (1)        */
-    0x01,               /* [1] id of the embedded MIDI OUT jack (1)         */
+    0x02,               /* [1] id of the embedded MIDI OUT jack (2)         */
 };
 
 
+/*
+ * RAM copy of the USB MIDI configuration descriptor.
+ * The endpoint poll interval is a user setting stored in the EEPROM, so
+ * the descriptor is copied from PROGMEM and adjusted in usb_init().
+ */
+static uint8_t config_descriptor[sizeof(usb_midi_config_descriptor)];
+
+
 /**
  * V-USB descriptor setup callback function
  */
@@ -150,9 +294,9 @@ usbFunctionDescriptor(usbRequest_t * request)
         usbMsgPtr = (uint8_t *) usb_midi_device_descriptor;
         return sizeof(usb_midi_device_descriptor);
 
-    } else {    /* must be config descriptor */
-        usbMsgPtr = (uint8_t *) usb_midi_config_descriptor;
-        return sizeof(usb_midi_config_descriptor);
+    } else {    /* must be config descriptor, served from RAM */
+        usbMsgPtr = config_descriptor;
+        return sizeof(config_descriptor);
     }
 }
 
@@ -166,10 +310,137 @@ usbFunctionSetup(uint8_t *data __attribute__((unused)))
 }
 
 
+/**
+ * V-USB interrupt / bulk OUT endpoint callback function.
+ * Called from within usbPoll() for every transfer the host sends to the
+ * MIDI OUT endpoint. A transfer can contain up to two USB MIDI event
+ * packets, of which only the single byte System Real-Time messages are
+ * of interest and passed on to the MIDI clock handling.
+ *
+ * @param data Received data
+ * @param len Length of received data in bytes
+ */
+void
+usbFunctionWriteOut(uint8_t *data, uint8_t len)
+{
+    while (len >= USB_MIDI_PACKET_SIZE) {
+        if ((data[0] & 0x0f) == USB_CIN_SINGLE_BYTE && data[1] >= 0xf8) {
+            clock_midi_realtime(data[1]);
+        }
+        data += USB_MIDI_PACKET_SIZE;
+        len  -= USB_MIDI_PACKET_SIZE;
+    }
+}
+
+/**
+ * Set up the USB MIDI configuration descriptor.
+ * Reads the endpoint poll interval from the EEPROM, falling back to the
+ * build time default USB_CFG_INTR_POLL_INTERVAL if the stored value isn't
+ * valid, and sets it in every endpoint descriptor of the RAM copy of the
+ * configuration descriptor. Call this before usbInit().
+ */
+void
+usb_init(void)
+{
+    uint8_t i;
+
+    poll_interval = eeprom_read_byte(&eeprom_data.settings.usb_poll_interval);
+    if (poll_interval == 0 || poll_interval > USB_POLL_INTERVAL_MAX) {
+        poll_interval = USB_CFG_INTR_POLL_INTERVAL;
+    }
+
+    memcpy_P(config_descriptor, usb_midi_config_descriptor,
+            sizeof(config_descriptor));
+
+    /* walk through all descriptors and adjust the endpoints' bInterval */
+    for (i = 0; i < sizeof(config_descriptor); i += config_descriptor[i]) {
+        if (config_descriptor[i + 1] == USBDESCR_ENDPOINT) {
+            config_descriptor[i + 6] = poll_interval;
+        }
+    }
+}
+
+/**
+ * Select the next interrupt endpoint poll interval.
+ * Cycles through the list of supported poll intervals, stores the new
+ * value in the EEPROM, and forces the host to re-enumerate the device,
+ * so the new interval takes effect right away.
+ */
+void
+usb_poll_interval_next(void)
+{
+    uint8_t i;
+    uint8_t next = poll_intervals[0];
+
+    for (i = 0; i < sizeof(poll_intervals) - 1; i++) {
+        if (poll_intervals[i] == poll_interval) {
+            next = poll_intervals[i + 1];
+            break;
+        }
+    }
+
+    eeprom_update_byte(&eeprom_data.settings.usb_poll_interval, next);
+    usb_init();
+
+    uart_print_pgm(interval_string);
+    uart_putint(poll_interval, 1);
+    uart_print_pgm(interval_ms_string);
+
+    /* disconnect long enough for the host to notice, see usbdrv.h */
+    usbDeviceDisconnect();
+    _delay_ms(250);
+    usbDeviceConnect();
+}
+
+/**
+ * Add a USB MIDI event packet to the transmit queue.
+ * Must be called with interrupts disabled.
+ *
+ * @param byte0 USB cable number and code index number
+ * @param byte1 MIDI message status byte
+ * @param byte2 MIDI message data byte 0
+ * @param byte3 MIDI message data byte 1
+ * @return 1 if the packet was queued, 0 if the queue is full
+ */
+static uint8_t
+tx_put(uint8_t byte0, uint8_t byte1, uint8_t byte2, uint8_t byte3)
+{
+    uint8_t *packet;
+
+    if ((uint8_t) (tx_head - tx_tail) == USB_MIDI_QUEUE_SIZE) {
+        if (!tx_overflowed) {
+            /* count each run of consecutive drops only once */
+            tx_overflowed = 1;
+            tx_overflows++;
+        }
+        tx_drops++;
+        return 0;
+    }
+
+    tx_overflowed = 0;
+
+    if (latency.enabled) {
+        tx_stamps[tx_head & (USB_MIDI_QUEUE_SIZE - 1)] = timer_get_timestamp();
+    }
+
+    packet = tx_queue[tx_head & (USB_MIDI_QUEUE_SIZE - 1)];
+    packet[0] = byte0;
+    packet[1] = byte1;
+    packet[2] = byte2;
+    packet[3] = byte3;
+    tx_head++;
+
+    return 1;
+}
+
 /**
  * Generic USB MIDI message send function.
  * USB MIDI messages are always 4 byte long (padding unused bytes with zero).
  *
+ * The message is not sent right away, but added to the transmit queue and
+ * sent from within usb_midi_poll() once the host polled all the previously
+ * queued messages. If the queue is full, the message is dropped.
+ *
  * See also chapter 4 in the Universal Serial Bus Device Class Definition
  * for MIDI Devices Release 1.0 document found at
  * https://usb.org/sites/default/files/midi10.pdf
@@ -185,20 +456,259 @@ usbFunctionSetup(uint8_t *data __attribute__((unused)))
 void
 usb_send_midi_message(uint8_t byte0, uint8_t byte1, uint8_t byte2, uint8_t byte3)
 {
-    static uint8_t midi_buf[4];
-    uint8_t retries = 10;
-
-    while (--retries) {
-        if (usbInterruptIsReady()) {
-            midi_buf[0] = byte0;
-            midi_buf[1] = byte1;
-            midi_buf[2] = byte2;
-            midi_buf[3] = byte3;
-            usbSetInterrupt(midi_buf, 4);
-            return;
+    uint8_t queued;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        queued = tx_put(byte0, byte1, byte2, byte3);
+    }
+
+    if (!queued) {
+        uart_print_pgm(send_failed_string);
+    }
+}
+
+/**
+ * Queue a USB MIDI event packet from within interrupt context.
+ * Same as usb_send_midi_message(), adding the packet to the regular
+ * transmit queue, so it can't overtake any message sent before it, e.g.
+ * a scheduled note-off its own note-on. Drops are only counted, nothing
+ * is printed from interrupt context.
+ *
+ * @param byte0 USB cable number and code index number
+ * @param byte1 MIDI message status byte
+ * @param byte2 MIDI message data byte 0
+ * @param byte3 MIDI message data byte 1
+ */
+void
+usb_send_midi_message_irq(uint8_t byte0, uint8_t byte1, uint8_t byte2, uint8_t byte3)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        tx_put(byte0, byte1, byte2, byte3);
+    }
+}
+
+/**
+ * Send a MIDI System Real-Time message over USB.
+ * The message goes to the real-time queue, which is always sent out first.
+ * If the queue is full, the message is dropped. Safe to call from both the
+ * main loop and interrupt context.
+ *
+ * @param status MIDI System Real-Time status byte
+ */
+void
+usb_send_midi_realtime(uint8_t status)
+{
+    volatile uint8_t *packet;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        if ((uint8_t) (irq_head - irq_tail) == USB_MIDI_IRQ_QUEUE_SIZE) {
+            irq_drops++;
+        } else {
+            packet = irq_queue[irq_head & (USB_MIDI_IRQ_QUEUE_SIZE - 1)];
+            packet[0] = USB_CMD_MIDI_SINGLE;
+            packet[1] = status;
+            packet[2] = 0;
+            packet[3] = 0;
+            irq_head++;
         }
-        _delay_ms(2);
     }
-    uart_print_pgm(send_failed_string);
 }
 
+/**
+ * Prepare a USB MIDI event packet for sending at a later point.
+ * The packet is added to the stage queue and held back until the next call
+ * to usb_midi_stage_commit(). Callers check usb_midi_stage_space() before
+ * preparing anything. If the stage queue is full nevertheless, everything
+ * staged so far is committed right away and the packet is added to the
+ * transmit queue after it, so it's sent early, but in order.
+ *
+ * Must only be called from the main loop.
+ *
+ * @param byte0 USB cable number and code index number
+ * @param byte1 MIDI message status byte
+ * @param byte2 MIDI message data byte 0
+ * @param byte3 MIDI message data byte 1
+ */
+void
+usb_stage_midi_message(uint8_t byte0, uint8_t byte1, uint8_t byte2, uint8_t byte3)
+{
+    uint8_t head = stage_head;
+    uint8_t *packet;
+
+    if ((uint8_t) (head - stage_tail) == USB_MIDI_STAGE_SIZE) {
+        usb_midi_stage_commit();
+        usb_send_midi_message(byte0, byte1, byte2, byte3);
+        return;
+    }
+
+    packet = stage_queue[head & (USB_MIDI_STAGE_SIZE - 1)];
+    packet[0] = byte0;
+    packet[1] = byte1;
+    packet[2] = byte2;
+    packet[3] = byte3;
+    stage_head = head + 1;
+}
+
+/**
+ * Get the number of packets that still fit in the stage queue.
+ * @return Number of free stage queue slots
+ */
+uint8_t
+usb_midi_stage_space(void)
+{
+    return USB_MIDI_STAGE_SIZE - (uint8_t) (stage_head - stage_tail);
+}
+
+/**
+ * Release all prepared USB MIDI event packets for sending.
+ * Moves the staged packets over to the transmit queue, in order and behind
+ * everything sent before the commit, e.g. a chord change's note-on that a
+ * staged note-off must not overtake. If the transmit queue runs full, the
+ * remaining packets are dropped. Safe to call from both the main loop and
+ * interrupt context.
+ */
+void
+usb_midi_stage_commit(void)
+{
+    uint8_t *packet;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        while (stage_tail != stage_head) {
+            packet = stage_queue[stage_tail & (USB_MIDI_STAGE_SIZE - 1)];
+            tx_put(packet[0], packet[1], packet[2], packet[3]);
+            stage_tail++;
+        }
+    }
+}
+
+/**
+ * Add a single latency measurement value to the latency statistics.
+ * @param value Measured latency in timer2 counts
+ */
+static void
+latency_add(uint16_t value)
+{
+    if (latency.count == 0 || value < latency.min) {
+        latency.min = value;
+    }
+    if (value > latency.max) {
+        latency.max = value;
+    }
+    latency.sum += value;
+    latency.count++;
+}
+
+/**
+ * USB MIDI transmit queue poll function.
+ * If the interrupt IN endpoint is ready to take new data, the oldest
+ * packets in the transmit queue are handed over to V-USB.
+ *
+ * The endpoint's max packet size is 8 bytes, so if there's more than one
+ * packet waiting in the queue, two USB MIDI event packets are combined in
+ * a single interrupt transfer. This halves the time it takes to get all
+ * notes of a chord to the host.
+ *
+ * MIDI System Real-Time messages, i.e. the MIDI clock, are always sent
+ * ahead of the regular transmit queue to keep their timing jitter low.
+ *
+ * Call this from inside the main loop, right after usbPoll().
+ */
+void
+usb_midi_poll(void)
+{
+    uint8_t transfer_buf[USB_MIDI_TRANSFER_SIZE];
+    uint8_t pending = tx_head - tx_tail;
+    uint8_t irq_pending = irq_head - irq_tail;
+    uint8_t len = 0;
+
+    if (!usbInterruptIsReady()) {
+        return;
+    }
+
+    if (latency.in_flight) {
+        /* endpoint is ready again, so the host polled the last transfer */
+        latency_add((uint16_t) (timer_get_timestamp() - latency.stamp));
+        latency.in_flight = 0;
+    }
+
+    if (pending == 0 && irq_pending == 0) {
+        return;
+    }
+
+    /* real-time queue first, its messages are timing critical */
+    while (irq_pending && len < USB_MIDI_TRANSFER_SIZE) {
+        memcpy(&transfer_buf[len], (uint8_t *) irq_queue[irq_tail & (USB_MIDI_IRQ_QUEUE_SIZE - 1)],
+                USB_MIDI_PACKET_SIZE);
+        len += USB_MIDI_PACKET_SIZE;
+        irq_tail++;
+        irq_pending--;
+    }
+
+    if (pending && len < USB_MIDI_TRANSFER_SIZE && latency.enabled) {
+        latency.stamp = tx_stamps[tx_tail & (USB_MIDI_QUEUE_SIZE - 1)];
+        latency.in_flight = 1;
+    }
+
+    while (pending && len < USB_MIDI_TRANSFER_SIZE) {
+        memcpy(&transfer_buf[len], tx_queue[tx_tail & (USB_MIDI_QUEUE_SIZE - 1)],
+                USB_MIDI_PACKET_SIZE);
+        len += USB_MIDI_PACKET_SIZE;
+        tx_tail++;
+        pending--;
+    }
+
+    usbSetInterrupt(transfer_buf, len);
+}
+
+/**
+ * Print the USB MIDI transmit queue statistics via UART.
+ * Shows the number of currently pending packets, how many times the
+ * queue ran full, and the total number of dropped packets.
+ */
+void
+usb_midi_print_stats(void)
+{
+    uart_print_pgm(queue_string);
+    uart_putint((uint8_t) (tx_head - tx_tail), 1);
+    uart_print_pgm(queue_pending_string);
+    uart_putint(tx_overflows, 1);
+    uart_print_pgm(queue_overflow_string);
+    uart_putint(tx_drops, 1);
+    uart_print_pgm(queue_drop_string);
+    uart_print_pgm(irq_queue_string);
+    uart_putint(irq_drops, 1);
+    uart_print_pgm(queue_drop_string);
+
+    if (latency.count > 0) {
+        uart_print_pgm(latency_string);
+        uart_putint(latency.count, 1);
+        uart_print_pgm(latency_min_string);
+        uart_putint(TIMESTAMP_TO_US(latency.min), 1);
+        uart_print_pgm(latency_avg_string);
+        uart_putint(TIMESTAMP_TO_US(latency.sum / latency.count), 1);
+        uart_print_pgm(latency_max_string);
+        uart_putint(TIMESTAMP_TO_US(latency.max), 1);
+        uart_print_pgm(latency_us_string);
+    }
+}
+
+/**
+ * Toggle the latency measurement mode.
+ * When enabled, previous measurement results are cleared, and the time
+ * between queuing a MIDI message and the host polling it is recorded.
+ * When disabled, the final results are printed via UART.
+ */
+void
+usb_latency_toggle(void)
+{
+    if (latency.enabled) {
+        latency.enabled = 0;
+        latency.in_flight = 0;
+        uart_print_pgm(latency_off_string);
+        usb_midi_print_stats();
+    } else {
+        memset(&latency, 0, sizeof(latency));
+        latency.enabled = 1;
+        uart_print_pgm(latency_on_string);
+    }
+}
@@ -18,20 +18,65 @@
  */
 #ifndef _USB_H_
 #define _USB_H_
+#include <stdint.h>
+
+/* size of a single USB MIDI event packet in bytes */
+#define USB_MIDI_PACKET_SIZE    4
+/* max number of bytes in a single interrupt transfer, two event packets */
+#define USB_MIDI_TRANSFER_SIZE  8
+/* number of packets the USB MIDI transmit queue can hold, power of 2 */
+#define USB_MIDI_QUEUE_SIZE     32
+/* number of packets the real-time message queue can hold, power of 2 */
+#define USB_MIDI_IRQ_QUEUE_SIZE 8
+/* number of packets the prepared message stage queue can hold, power of 2 */
+#define USB_MIDI_STAGE_SIZE     32
+
+/* longest supported interrupt endpoint poll interval in ms */
+#define USB_POLL_INTERVAL_MAX   10
 
 #define USB_MIDI_CABLE_NUM      0
 #define MIDI_CHANNEL_NUMBER     0
 
+/* USB MIDI code index number for single byte messages */
+#define USB_CIN_SINGLE_BYTE     0x0f
+
 #define USB_CMD_MIDI_NOTE_ON    ((USB_MIDI_CABLE_NUM << 4) | 0x09)
 #define USB_CMD_MIDI_NOTE_OFF   ((USB_MIDI_CABLE_NUM << 4) | 0x08)
+#define USB_CMD_MIDI_CONTROL    ((USB_MIDI_CABLE_NUM << 4) | 0x0b)
+#define USB_CMD_MIDI_SINGLE     ((USB_MIDI_CABLE_NUM << 4) | USB_CIN_SINGLE_BYTE)
 
 #define MIDI_NOTE_ON    (0x90 | MIDI_CHANNEL_NUMBER)
 #define MIDI_NOTE_OFF   (0x80 | MIDI_CHANNEL_NUMBER)
+#define MIDI_CONTROL    (0xb0 | MIDI_CHANNEL_NUMBER)
+
+/* MIDI controller number of the sustain pedal */
+#define MIDI_CC_SUSTAIN 64
+
+/**
+ * Set up the USB MIDI configuration descriptor.
+ * Reads the endpoint poll interval from the EEPROM, falling back to the
+ * build time default USB_CFG_INTR_POLL_INTERVAL if the stored value isn't
+ * valid, and sets it in every endpoint descriptor of the RAM copy of the
+ * configuration descriptor. Call this before usbInit().
+ */
+void usb_init(void);
+
+/**
+ * Select the next interrupt endpoint poll interval.
+ * Cycles through the list of supported poll intervals, stores the new
+ * value in the EEPROM, and forces the host to re-enumerate the device,
+ * so the new interval takes effect right away.
+ */
+void usb_poll_interval_next(void);
 
 /**
  * Generic USB MIDI message send function.
  * USB MIDI messages are always 4 byte long (padding unused bytes with zero).
  *
+ * The message is not sent right away, but added to the transmit queue and
+ * sent from within usb_midi_poll() once the host polled all the previously
+ * queued messages. If the queue is full, the message is dropped.
+ *
  * See also chapter 4 in the Universal Serial Bus Device Class Definition
  * for MIDI Devices Release 1.0 document found at
  * https://usb.org/sites/default/files/midi10.pdf
@@ -46,6 +91,89 @@
  */
 void usb_send_midi_message(uint8_t byte0, uint8_t byte1, uint8_t byte2, uint8_t byte3);
 
+/**
+ * Queue a USB MIDI event packet from within interrupt context.
+ * Same as usb_send_midi_message(), adding the packet to the regular
+ * transmit queue, so it can't overtake any message sent before it, e.g.
+ * a scheduled note-off its own note-on. Drops are only counted, nothing
+ * is printed from interrupt context.
+ *
+ * @param byte0 USB cable number and code index number
+ * @param byte1 MIDI message status byte
+ * @param byte2 MIDI message data byte 0
+ * @param byte3 MIDI message data byte 1
+ */
+void usb_send_midi_message_irq(uint8_t byte0, uint8_t byte1, uint8_t byte2, uint8_t byte3);
+
+/**
+ * Send a MIDI System Real-Time message over USB.
+ * The message goes to the real-time queue, which is always sent out first.
+ * If the queue is full, the message is dropped. Safe to call from both the
+ * main loop and interrupt context.
+ *
+ * @param status MIDI System Real-Time status byte
+ */
+void usb_send_midi_realtime(uint8_t status);
+
+/**
+ * Prepare a USB MIDI event packet for sending at a later point.
+ * The packet is added to the stage queue and held back until the next call
+ * to usb_midi_stage_commit(). Callers check usb_midi_stage_space() before
+ * preparing anything. If the stage queue is full nevertheless, everything
+ * staged so far is committed right away and the packet is added to the
+ * transmit queue after it, so it's sent early, but in order.
+ *
+ * Must only be called from the main loop.
+ *
+ * @param byte0 USB cable number and code index number
+ * @param byte1 MIDI message status byte
+ * @param byte2 MIDI message data byte 0
+ * @param byte3 MIDI message data byte 1
+ */
+void usb_stage_midi_message(uint8_t byte0, uint8_t byte1, uint8_t byte2, uint8_t byte3);
+
+/**
+ * Get the number of packets that still fit in the stage queue.
+ * @return Number of free stage queue slots
+ */
+uint8_t usb_midi_stage_space(void);
+
+/**
+ * Release all prepared USB MIDI event packets for sending.
+ * Moves the staged packets over to the transmit queue, in order and behind
+ * everything sent before the commit, e.g. a chord change's note-on that a
+ * staged note-off must not overtake. If the transmit queue runs full, the
+ * remaining packets are dropped. Safe to call from both the main loop and
+ * interrupt context.
+ */
+void usb_midi_stage_commit(void);
+
+/**
+ * USB MIDI transmit queue poll function.
+ * If the interrupt IN endpoint is ready to take new data, the oldest
+ * packets in the transmit queue are handed over to V-USB, two USB MIDI
+ * event packets per interrupt transfer if there's more than one waiting.
+ * Messages queued from interrupt context are sent ahead of all others,
+ * followed by the committed messages of the stage queue.
+ * Call this from inside the main loop, right after usbPoll().
+ */
+void usb_midi_poll(void);
+
+/**
+ * Print the USB MIDI transmit queue statistics via UART.
+ * Shows the number of currently pending packets, how many times the
+ * queue ran full, and the total number of dropped packets.
+ */
+void usb_midi_print_stats(void);
+
+/**
+ * Toggle the latency measurement mode.
+ * When enabled, previous measurement results are cleared, and the time
+ * between queuing a MIDI message and the host polling it is recorded.
+ * When disabled, the final results are printed via UART.
+ */
+void usb_latency_toggle(void);
+
 /**
  * Send a MIDI "Note On" message over USB.
  * @param note MIDI note key number
@@ -62,4 +190,44 @@ void usb_send_midi_message(uint8_t byte0, uint8_t byte1, uint8_t byte2, uint8_t
 #define midi_msg_note_off(note, velocity) \
     usb_send_midi_message(USB_CMD_MIDI_NOTE_OFF, MIDI_NOTE_OFF, note, velocity)
 
+/**
+ * Send a MIDI "Control Change" message over USB.
+ * @param control MIDI controller number
+ * @param value MIDI controller value
+ */
+#define midi_msg_control_change(control, value) \
+    usb_send_midi_message(USB_CMD_MIDI_CONTROL, MIDI_CONTROL, control, value)
+
+/**
+ * Prepare a MIDI "Note On" message to be sent on the next stage commit.
+ * @param note MIDI note key number
+ * @param velocity MIDI note velocity
+ */
+#define midi_stage_note_on(note, velocity) \
+    usb_stage_midi_message(USB_CMD_MIDI_NOTE_ON, MIDI_NOTE_ON, note, velocity)
+
+/**
+ * Prepare a MIDI "Note Off" message to be sent on the next stage commit.
+ * @param note MIDI note key number
+ * @param velocity MIDI note velocity
+ */
+#define midi_stage_note_off(note, velocity) \
+    usb_stage_midi_message(USB_CMD_MIDI_NOTE_OFF, MIDI_NOTE_OFF, note, velocity)
+
+/**
+ * Prepare a MIDI "Control Change" message to be sent on the next stage commit.
+ * @param control MIDI controller number
+ * @param value MIDI controller value
+ */
+#define midi_stage_control_change(control, value) \
+    usb_stage_midi_message(USB_CMD_MIDI_CONTROL, MIDI_CONTROL, control, value)
+
+/**
+ * Send a MIDI "Note Off" message over USB from interrupt context.
+ * @param note MIDI note key number
+ * @param velocity MIDI note velocity
+ */
+#define midi_msg_note_off_irq(note, velocity) \
+    usb_send_midi_message_irq(USB_CMD_MIDI_NOTE_OFF, MIDI_NOTE_OFF, note, velocity)
+
 #endif
@@ -101,10 +101,17 @@
  * (e.g. HID), but never want to send any data. This option saves a couple
  * of bytes in flash memory and the transmit buffers in RAM.
  */
+#ifndef USB_CFG_INTR_POLL_INTERVAL
 #define USB_CFG_INTR_POLL_INTERVAL      10
+#endif
 /* If you compile a version with endpoint 1 (interrupt-in), this is the poll
  * interval. The value is in milliseconds and must not be less than 10 ms for
  * low speed devices.
+ *
+ * 4chord MIDI: this is only the build time default, set through the
+ * USB_POLL_INTERVAL Makefile variable. The actual value is stored in the
+ * EEPROM and can be lowered (down to 1ms) at runtime, see usb_init().
+ * The USB spec won't allow less than 10ms, but most hosts honor it anyway.
  */
 #define USB_CFG_IS_SELF_POWERED         0
 /* Define this to 1 if the device has its own power supply. Set it to 0 if the
@@ -126,7 +133,7 @@
  * data from a static buffer, set it to 0 and return the data from
  * usbFunctionSetup(). This saves a couple of bytes.
  */
-#define USB_CFG_IMPLEMENT_FN_WRITEOUT   0
+#define USB_CFG_IMPLEMENT_FN_WRITEOUT   1
 /* Define this to 1 if you want to use interrupt-out (or bulk out) endpoints.
  * You must implement the function usbFunctionWriteOut() which receives all
  * interrupt/bulk data sent to any endpoint other than 0. The endpoint number
@@ -337,7 +344,7 @@
  */
 
 #define USB_CFG_DESCR_PROPS_DEVICE                  USB_PROP_IS_DYNAMIC
-#define USB_CFG_DESCR_PROPS_CONFIGURATION           USB_PROP_IS_DYNAMIC
+#define USB_CFG_DESCR_PROPS_CONFIGURATION           (USB_PROP_IS_DYNAMIC | USB_PROP_IS_RAM)
 #define USB_CFG_DESCR_PROPS_STRINGS                 0
 #define USB_CFG_DESCR_PROPS_STRING_0                0
 #define USB_CFG_DESCR_PROPS_STRING_VENDOR           0
@@ -0,0 +1,1176 @@
+/*
+ * chord voicing tables
+ * auto-generated by voicegen
+ */
+#include <avr/pgmspace.h>
+#include <stdint.h>
+#include "voicings.h"
+
+/* triads plus octave, [key][chord][inversion][note] */
+const uint8_t voicings_triad[VOICING_KEYS][VOICING_DEGREES][3][4] PROGMEM = {
+    {   /* C */
+        {   /* I */
+            { 48,  52,  55,  60},
+            { 52,  55,  60,  64},
+            { 55,  60,  64,  67},
+        },
+        {   /* V */
+            { 43,  47,  50,  55},
+            { 47,  50,  55,  59},
+            { 50,  55,  59,  62},
+        },
+        {   /* vi */
+            { 45,  48,  52,  57},
+            { 48,  52,  57,  60},
+            { 52,  57,  60,  64},
+        },
+        {   /* IV */
+            { 41,  45,  48,  53},
+            { 45,  48,  53,  57},
+            { 48,  53,  57,  60},
+        },
+    },
+    {   /* C# */
+        {   /* I */
+            { 49,  53,  56,  61},
+            { 53,  56,  61,  65},
+            { 56,  61,  65,  68},
+        },
+        {   /* V */
+            { 44,  48,  51,  56},
+            { 48,  51,  56,  60},
+            { 51,  56,  60,  63},
+        },
+        {   /* vi */
+            { 46,  49,  53,  58},
+            { 49,  53,  58,  61},
+            { 53,  58,  61,  65},
+        },
+        {   /* IV */
+            { 42,  46,  49,  54},
+            { 46,  49,  54,  58},
+            { 49,  54,  58,  61},
+        },
+    },
+    {   /* D */
+        {   /* I */
+            { 50,  54,  57,  62},
+            { 54,  57,  62,  66},
+            { 57,  62,  66,  69},
+        },
+        {   /* V */
+            { 45,  49,  52,  57},
+            { 49,  52,  57,  61},
+            { 52,  57,  61,  64},
+        },
+        {   /* vi */
+            { 47,  50,  54,  59},
+            { 50,  54,  59,  62},
+            { 54,  59,  62,  66},
+        },
+        {   /* IV */
+            { 43,  47,  50,  55},
+            { 47,  50,  55,  59},
+            { 50,  55,  59,  62},
+        },
+    },
+    {   /* D# */
+        {   /* I */
+            { 51,  55,  58,  63},
+            { 55,  58,  63,  67},
+            { 58,  63,  67,  70},
+        },
+        {   /* V */
+            { 46,  50,  53,  58},
+            { 50,  53,  58,  62},
+            { 53,  58,  62,  65},
+        },
+        {   /* vi */
+            { 48,  51,  55,  60},
+            { 51,  55,  60,  63},
+            { 55,  60,  63,  67},
+        },
+        {   /* IV */
+            { 44,  48,  51,  56},
+            { 48,  51,  56,  60},
+            { 51,  56,  60,  63},
+        },
+    },
+    {   /* E */
+        {   /* I */
+            { 52,  56,  59,  64},
+            { 56,  59,  64,  68},
+            { 59,  64,  68,  71},
+        },
+        {   /* V */
+            { 47,  51,  54,  59},
+            { 51,  54,  59,  63},
+            { 54,  59,  63,  66},
+        },
+        {   /* vi */
+            { 49,  52,  56,  61},
+            { 52,  56,  61,  64},
+            { 56,  61,  64,  68},
+        },
+        {   /* IV */
+            { 45,  49,  52,  57},
+            { 49,  52,  57,  61},
+            { 52,  57,  61,  64},
+        },
+    },
+    {   /* F */
+        {   /* I */
+            { 53,  57,  60,  65},
+            { 57,  60,  65,  69},
+            { 60,  65,  69,  72},
+        },
+        {   /* V */
+            { 48,  52,  55,  60},
+            { 52,  55,  60,  64},
+            { 55,  60,  64,  67},
+        },
+        {   /* vi */
+            { 50,  53,  57,  62},
+            { 53,  57,  62,  65},
+            { 57,  62,  65,  69},
+        },
+        {   /* IV */
+            { 46,  50,  53,  58},
+            { 50,  53,  58,  62},
+            { 53,  58,  62,  65},
+        },
+    },
+    {   /* F# */
+        {   /* I */
+            { 54,  58,  61,  66},
+            { 58,  61,  66,  70},
+            { 61,  66,  70,  73},
+        },
+        {   /* V */
+            { 49,  53,  56,  61},
+            { 53,  56,  61,  65},
+            { 56,  61,  65,  68},
+        },
+        {   /* vi */
+            { 51,  54,  58,  63},
+            { 54,  58,  63,  66},
+            { 58,  63,  66,  70},
+        },
+        {   /* IV */
+            { 47,  51,  54,  59},
+            { 51,  54,  59,  63},
+            { 54,  59,  63,  66},
+        },
+    },
+    {   /* G */
+        {   /* I */
+            { 43,  47,  50,  55},
+            { 47,  50,  55,  59},
+            { 50,  55,  59,  62},
+        },
+        {   /* V */
+            { 50,  54,  57,  62},
+            { 54,  57,  62,  66},
+            { 57,  62,  66,  69},
+        },
+        {   /* vi */
+            { 52,  55,  59,  64},
+            { 55,  59,  64,  67},
+            { 59,  64,  67,  71},
+        },
+        {   /* IV */
+            { 48,  52,  55,  60},
+            { 52,  55,  60,  64},
+            { 55,  60,  64,  67},
+        },
+    },
+    {   /* G# */
+        {   /* I */
+            { 44,  48,  51,  56},
+            { 48,  51,  56,  60},
+            { 51,  56,  60,  63},
+        },
+        {   /* V */
+            { 51,  55,  58,  63},
+            { 55,  58,  63,  67},
+            { 58,  63,  67,  70},
+        },
+        {   /* vi */
+            { 53,  56,  60,  65},
+            { 56,  60,  65,  68},
+            { 60,  65,  68,  72},
+        },
+        {   /* IV */
+            { 49,  53,  56,  61},
+            { 53,  56,  61,  65},
+            { 56,  61,  65,  68},
+        },
+    },
+    {   /* A */
+        {   /* I */
+            { 45,  49,  52,  57},
+            { 49,  52,  57,  61},
+            { 52,  57,  61,  64},
+        },
+        {   /* V */
+            { 52,  56,  59,  64},
+            { 56,  59,  64,  68},
+            { 59,  64,  68,  71},
+        },
+        {   /* vi */
+            { 54,  57,  61,  66},
+            { 57,  61,  66,  69},
+            { 61,  66,  69,  73},
+        },
+        {   /* IV */
+            { 50,  54,  57,  62},
+            { 54,  57,  62,  66},
+            { 57,  62,  66,  69},
+        },
+    },
+    {   /* Bb */
+        {   /* I */
+            { 46,  50,  53,  58},
+            { 50,  53,  58,  62},
+            { 53,  58,  62,  65},
+        },
+        {   /* V */
+            { 41,  45,  48,  53},
+            { 45,  48,  53,  57},
+            { 48,  53,  57,  60},
+        },
+        {   /* vi */
+            { 43,  46,  50,  55},
+            { 46,  50,  55,  58},
+            { 50,  55,  58,  62},
+        },
+        {   /* IV */
+            { 39,  43,  46,  51},
+            { 43,  46,  51,  55},
+            { 46,  51,  55,  58},
+        },
+    },
+    {   /* B */
+        {   /* I */
+            { 47,  51,  54,  59},
+            { 51,  54,  59,  63},
+            { 54,  59,  63,  66},
+        },
+        {   /* V */
+            { 42,  46,  49,  54},
+            { 46,  49,  54,  58},
+            { 49,  54,  58,  61},
+        },
+        {   /* vi */
+            { 44,  47,  51,  56},
+            { 47,  51,  56,  59},
+            { 51,  56,  59,  63},
+        },
+        {   /* IV */
+            { 40,  44,  47,  52},
+            { 44,  47,  52,  56},
+            { 47,  52,  56,  59},
+        },
+    },
+};
+
+/* seventh chords plus octave, [key][chord][inversion][note] */
+const uint8_t voicings_seventh[VOICING_KEYS][VOICING_DEGREES][4][5] PROGMEM = {
+    {   /* C */
+        {   /* I */
+            { 48,  52,  55,  59,  60},
+            { 52,  55,  59,  60,  64},
+            { 55,  59,  60,  64,  67},
+            { 59,  60,  64,  67,  71},
+        },
+        {   /* V */
+            { 43,  47,  50,  53,  55},
+            { 47,  50,  53,  55,  59},
+            { 50,  53,  55,  59,  62},
+            { 53,  55,  59,  62,  65},
+        },
+        {   /* vi */
+            { 45,  48,  52,  55,  57},
+            { 48,  52,  55,  57,  60},
+            { 52,  55,  57,  60,  64},
+            { 55,  57,  60,  64,  67},
+        },
+        {   /* IV */
+            { 41,  45,  48,  52,  53},
+            { 45,  48,  52,  53,  57},
+            { 48,  52,  53,  57,  60},
+            { 52,  53,  57,  60,  64},
+        },
+    },
+    {   /* C# */
+        {   /* I */
+            { 49,  53,  56,  60,  61},
+            { 53,  56,  60,  61,  65},
+            { 56,  60,  61,  65,  68},
+            { 60,  61,  65,  68,  72},
+        },
+        {   /* V */
+            { 44,  48,  51,  54,  56},
+            { 48,  51,  54,  56,  60},
+            { 51,  54,  56,  60,  63},
+            { 54,  56,  60,  63,  66},
+        },
+        {   /* vi */
+            { 46,  49,  53,  56,  58},
+            { 49,  53,  56,  58,  61},
+            { 53,  56,  58,  61,  65},
+            { 56,  58,  61,  65,  68},
+        },
+        {   /* IV */
+            { 42,  46,  49,  53,  54},
+            { 46,  49,  53,  54,  58},
+            { 49,  53,  54,  58,  61},
+            { 53,  54,  58,  61,  65},
+        },
+    },
+    {   /* D */
+        {   /* I */
+            { 50,  54,  57,  61,  62},
+            { 54,  57,  61,  62,  66},
+            { 57,  61,  62,  66,  69},
+            { 61,  62,  66,  69,  73},
+        },
+        {   /* V */
+            { 45,  49,  52,  55,  57},
+            { 49,  52,  55,  57,  61},
+            { 52,  55,  57,  61,  64},
+            { 55,  57,  61,  64,  67},
+        },
+        {   /* vi */
+            { 47,  50,  54,  57,  59},
+            { 50,  54,  57,  59,  62},
+            { 54,  57,  59,  62,  66},
+            { 57,  59,  62,  66,  69},
+        },
+        {   /* IV */
+            { 43,  47,  50,  54,  55},
+            { 47,  50,  54,  55,  59},
+            { 50,  54,  55,  59,  62},
+            { 54,  55,  59,  62,  66},
+        },
+    },
+    {   /* D# */
+        {   /* I */
+            { 51,  55,  58,  62,  63},
+            { 55,  58,  62,  63,  67},
+            { 58,  62,  63,  67,  70},
+            { 62,  63,  67,  70,  74},
+        },
+        {   /* V */
+            { 46,  50,  53,  56,  58},
+            { 50,  53,  56,  58,  62},
+            { 53,  56,  58,  62,  65},
+            { 56,  58,  62,  65,  68},
+        },
+        {   /* vi */
+            { 48,  51,  55,  58,  60},
+            { 51,  55,  58,  60,  63},
+            { 55,  58,  60,  63,  67},
+            { 58,  60,  63,  67,  70},
+        },
+        {   /* IV */
+            { 44,  48,  51,  55,  56},
+            { 48,  51,  55,  56,  60},
+            { 51,  55,  56,  60,  63},
+            { 55,  56,  60,  63,  67},
+        },
+    },
+    {   /* E */
+        {   /* I */
+            { 52,  56,  59,  63,  64},
+            { 56,  59,  63,  64,  68},
+            { 59,  63,  64,  68,  71},
+            { 63,  64,  68,  71,  75},
+        },
+        {   /* V */
+            { 47,  51,  54,  57,  59},
+            { 51,  54,  57,  59,  63},
+            { 54,  57,  59,  63,  66},
+            { 57,  59,  63,  66,  69},
+        },
+        {   /* vi */
+            { 49,  52,  56,  59,  61},
+            { 52,  56,  59,  61,  64},
+            { 56,  59,  61,  64,  68},
+            { 59,  61,  64,  68,  71},
+        },
+        {   /* IV */
+            { 45,  49,  52,  56,  57},
+            { 49,  52,  56,  57,  61},
+            { 52,  56,  57,  61,  64},
+            { 56,  57,  61,  64,  68},
+        },
+    },
+    {   /* F */
+        {   /* I */
+            { 53,  57,  60,  64,  65},
+            { 57,  60,  64,  65,  69},
+            { 60,  64,  65,  69,  72},
+            { 64,  65,  69,  72,  76},
+        },
+        {   /* V */
+            { 48,  52,  55,  58,  60},
+            { 52,  55,  58,  60,  64},
+            { 55,  58,  60,  64,  67},
+            { 58,  60,  64,  67,  70},
+        },
+        {   /* vi */
+            { 50,  53,  57,  60,  62},
+            { 53,  57,  60,  62,  65},
+            { 57,  60,  62,  65,  69},
+            { 60,  62,  65,  69,  72},
+        },
+        {   /* IV */
+            { 46,  50,  53,  57,  58},
+            { 50,  53,  57,  58,  62},
+            { 53,  57,  58,  62,  65},
+            { 57,  58,  62,  65,  69},
+        },
+    },
+    {   /* F# */
+        {   /* I */
+            { 54,  58,  61,  65,  66},
+            { 58,  61,  65,  66,  70},
+            { 61,  65,  66,  70,  73},
+            { 65,  66,  70,  73,  77},
+        },
+        {   /* V */
+            { 49,  53,  56,  59,  61},
+            { 53,  56,  59,  61,  65},
+            { 56,  59,  61,  65,  68},
+            { 59,  61,  65,  68,  71},
+        },
+        {   /* vi */
+            { 51,  54,  58,  61,  63},
+            { 54,  58,  61,  63,  66},
+            { 58,  61,  63,  66,  70},
+            { 61,  63,  66,  70,  73},
+        },
+        {   /* IV */
+            { 47,  51,  54,  58,  59},
+            { 51,  54,  58,  59,  63},
+            { 54,  58,  59,  63,  66},
+            { 58,  59,  63,  66,  70},
+        },
+    },
+    {   /* G */
+        {   /* I */
+            { 43,  47,  50,  54,  55},
+            { 47,  50,  54,  55,  59},
+            { 50,  54,  55,  59,  62},
+            { 54,  55,  59,  62,  66},
+        },
+        {   /* V */
+            { 50,  54,  57,  60,  62},
+            { 54,  57,  60,  62,  66},
+            { 57,  60,  62,  66,  69},
+            { 60,  62,  66,  69,  72},
+        },
+        {   /* vi */
+            { 52,  55,  59,  62,  64},
+            { 55,  59,  62,  64,  67},
+            { 59,  62,  64,  67,  71},
+            { 62,  64,  67,  71,  74},
+        },
+        {   /* IV */
+            { 48,  52,  55,  59,  60},
+            { 52,  55,  59,  60,  64},
+            { 55,  59,  60,  64,  67},
+            { 59,  60,  64,  67,  71},
+        },
+    },
+    {   /* G# */
+        {   /* I */
+            { 44,  48,  51,  55,  56},
+            { 48,  51,  55,  56,  60},
+            { 51,  55,  56,  60,  63},
+            { 55,  56,  60,  63,  67},
+        },
+        {   /* V */
+            { 51,  55,  58,  61,  63},
+            { 55,  58,  61,  63,  67},
+            { 58,  61,  63,  67,  70},
+            { 61,  63,  67,  70,  73},
+        },
+        {   /* vi */
+            { 53,  56,  60,  63,  65},
+            { 56,  60,  63,  65,  68},
+            { 60,  63,  65,  68,  72},
+            { 63,  65,  68,  72,  75},
+        },
+        {   /* IV */
+            { 49,  53,  56,  60,  61},
+            { 53,  56,  60,  61,  65},
+            { 56,  60,  61,  65,  68},
+            { 60,  61,  65,  68,  72},
+        },
+    },
+    {   /* A */
+        {   /* I */
+            { 45,  49,  52,  56,  57},
+            { 49,  52,  56,  57,  61},
+            { 52,  56,  57,  61,  64},
+            { 56,  57,  61,  64,  68},
+        },
+        {   /* V */
+            { 52,  56,  59,  62,  64},
+            { 56,  59,  62,  64,  68},
+            { 59,  62,  64,  68,  71},
+            { 62,  64,  68,  71,  74},
+        },
+        {   /* vi */
+            { 54,  57,  61,  64,  66},
+            { 57,  61,  64,  66,  69},
+            { 61,  64,  66,  69,  73},
+            { 64,  66,  69,  73,  76},
+        },
+        {   /* IV */
+            { 50,  54,  57,  61,  62},
+            { 54,  57,  61,  62,  66},
+            { 57,  61,  62,  66,  69},
+            { 61,  62,  66,  69,  73},
+        },
+    },
+    {   /* Bb */
+        {   /* I */
+            { 46,  50,  53,  57,  58},
+            { 50,  53,  57,  58,  62},
+            { 53,  57,  58,  62,  65},
+            { 57,  58,  62,  65,  69},
+        },
+        {   /* V */
+            { 41,  45,  48,  51,  53},
+            { 45,  48,  51,  53,  57},
+            { 48,  51,  53,  57,  60},
+            { 51,  53,  57,  60,  63},
+        },
+        {   /* vi */
+            { 43,  46,  50,  53,  55},
+            { 46,  50,  53,  55,  58},
+            { 50,  53,  55,  58,  62},
+            { 53,  55,  58,  62,  65},
+        },
+        {   /* IV */
+            { 39,  43,  46,  50,  51},
+            { 43,  46,  50,  51,  55},
+            { 46,  50,  51,  55,  58},
+            { 50,  51,  55,  58,  62},
+        },
+    },
+    {   /* B */
+        {   /* I */
+            { 47,  51,  54,  58,  59},
+            { 51,  54,  58,  59,  63},
+            { 54,  58,  59,  63,  66},
+            { 58,  59,  63,  66,  70},
+        },
+        {   /* V */
+            { 42,  46,  49,  52,  54},
+            { 46,  49,  52,  54,  58},
+            { 49,  52,  54,  58,  61},
+            { 52,  54,  58,  61,  64},
+        },
+        {   /* vi */
+            { 44,  47,  51,  54,  56},
+            { 47,  51,  54,  56,  59},
+            { 51,  54,  56,  59,  63},
+            { 54,  56,  59,  63,  66},
+        },
+        {   /* IV */
+            { 40,  44,  47,  51,  52},
+            { 44,  47,  51,  52,  56},
+            { 47,  51,  52,  56,  59},
+            { 51,  52,  56,  59,  63},
+        },
+    },
+};
+
+/* closest triad inversion, [key][current chord][current inversion][next chord] */
+const uint8_t voicings_lead_triad[VOICING_KEYS][VOICING_DEGREES][3][VOICING_DEGREES] PROGMEM = {
+    {   /* C */
+        {   /* from I */
+            {0, 1, 1, 2},
+            {1, 2, 2, 2},
+            {2, 2, 2, 2},
+        },
+        {   /* from V */
+            {0, 0, 0, 0},
+            {0, 1, 1, 2},
+            {1, 2, 2, 2},
+        },
+        {   /* from vi */
+            {0, 0, 0, 1},
+            {0, 1, 1, 2},
+            {1, 2, 2, 2},
+        },
+        {   /* from IV */
+            {0, 0, 0, 0},
+            {0, 0, 0, 1},
+            {0, 1, 1, 2},
+        },
+    },
+    {   /* C# */
+        {   /* from I */
+            {0, 1, 1, 2},
+            {1, 2, 2, 2},
+            {2, 2, 2, 2},
+        },
+        {   /* from V */
+            {0, 0, 0, 0},
+            {0, 1, 1, 2},
+            {1, 2, 2, 2},
+        },
+        {   /* from vi */
+            {0, 0, 0, 1},
+            {0, 1, 1, 2},
+            {1, 2, 2, 2},
+        },
+        {   /* from IV */
+            {0, 0, 0, 0},
+            {0, 0, 0, 1},
+            {0, 1, 1, 2},
+        },
+    },
+    {   /* D */
+        {   /* from I */
+            {0, 1, 1, 2},
+            {1, 2, 2, 2},
+            {2, 2, 2, 2},
+        },
+        {   /* from V */
+            {0, 0, 0, 0},
+            {0, 1, 1, 2},
+            {1, 2, 2, 2},
+        },
+        {   /* from vi */
+            {0, 0, 0, 1},
+            {0, 1, 1, 2},
+            {1, 2, 2, 2},
+        },
+        {   /* from IV */
+            {0, 0, 0, 0},
+            {0, 0, 0, 1},
+            {0, 1, 1, 2},
+        },
+    },
+    {   /* D# */
+        {   /* from I */
+            {0, 1, 1, 2},
+            {1, 2, 2, 2},
+            {2, 2, 2, 2},
+        },
+        {   /* from V */
+            {0, 0, 0, 0},
+            {0, 1, 1, 2},
+            {1, 2, 2, 2},
+        },
+        {   /* from vi */
+            {0, 0, 0, 1},
+            {0, 1, 1, 2},
+            {1, 2, 2, 2},
+        },
+        {   /* from IV */
+            {0, 0, 0, 0},
+            {0, 0, 0, 1},
+            {0, 1, 1, 2},
+        },
+    },
+    {   /* E */
+        {   /* from I */
+            {0, 1, 1, 2},
+            {1, 2, 2, 2},
+            {2, 2, 2, 2},
+        },
+        {   /* from V */
+            {0, 0, 0, 0},
+            {0, 1, 1, 2},
+            {1, 2, 2, 2},
+        },
+        {   /* from vi */
+            {0, 0, 0, 1},
+            {0, 1, 1, 2},
+            {1, 2, 2, 2},
+        },
+        {   /* from IV */
+            {0, 0, 0, 0},
+            {0, 0, 0, 1},
+            {0, 1, 1, 2},
+        },
+    },
+    {   /* F */
+        {   /* from I */
+            {0, 1, 1, 2},
+            {1, 2, 2, 2},
+            {2, 2, 2, 2},
+        },
+        {   /* from V */
+            {0, 0, 0, 0},
+            {0, 1, 1, 2},
+            {1, 2, 2, 2},
+        },
+        {   /* from vi */
+            {0, 0, 0, 1},
+            {0, 1, 1, 2},
+            {1, 2, 2, 2},
+        },
+        {   /* from IV */
+            {0, 0, 0, 0},
+            {0, 0, 0, 1},
+            {0, 1, 1, 2},
+        },
+    },
+    {   /* F# */
+        {   /* from I */
+            {0, 1, 1, 2},
+            {1, 2, 2, 2},
+            {2, 2, 2, 2},
+        },
+        {   /* from V */
+            {0, 0, 0, 0},
+            {0, 1, 1, 2},
+            {1, 2, 2, 2},
+        },
+        {   /* from vi */
+            {0, 0, 0, 1},
+            {0, 1, 1, 2},
+            {1, 2, 2, 2},
+        },
+        {   /* from IV */
+            {0, 0, 0, 0},
+            {0, 0, 0, 1},
+            {0, 1, 1, 2},
+        },
+    },
+    {   /* G */
+        {   /* from I */
+            {0, 0, 0, 0},
+            {1, 0, 0, 0},
+            {2, 0, 0, 1},
+        },
+        {   /* from V */
+            {2, 0, 0, 0},
+            {2, 1, 1, 2},
+            {2, 2, 2, 2},
+        },
+        {   /* from vi */
+            {2, 0, 0, 1},
+            {2, 1, 1, 2},
+            {2, 2, 2, 2},
+        },
+        {   /* from IV */
+            {1, 0, 0, 0},
+            {2, 0, 0, 1},
+            {2, 1, 1, 2},
+        },
+    },
+    {   /* G# */
+        {   /* from I */
+            {0, 0, 0, 0},
+            {1, 0, 0, 0},
+            {2, 0, 0, 1},
+        },
+        {   /* from V */
+            {2, 0, 0, 0},
+            {2, 1, 1, 2},
+            {2, 2, 2, 2},
+        },
+        {   /* from vi */
+            {2, 0, 0, 1},
+            {2, 1, 1, 2},
+            {2, 2, 2, 2},
+        },
+        {   /* from IV */
+            {1, 0, 0, 0},
+            {2, 0, 0, 1},
+            {2, 1, 1, 2},
+        },
+    },
+    {   /* A */
+        {   /* from I */
+            {0, 0, 0, 0},
+            {1, 0, 0, 0},
+            {2, 0, 0, 1},
+        },
+        {   /* from V */
+            {2, 0, 0, 0},
+            {2, 1, 1, 2},
+            {2, 2, 2, 2},
+        },
+        {   /* from vi */
+            {2, 0, 0, 1},
+            {2, 1, 1, 2},
+            {2, 2, 2, 2},
+        },
+        {   /* from IV */
+            {1, 0, 0, 0},
+            {2, 0, 0, 1},
+            {2, 1, 1, 2},
+        },
+    },
+    {   /* Bb */
+        {   /* from I */
+            {0, 1, 1, 2},
+            {1, 2, 2, 2},
+            {2, 2, 2, 2},
+        },
+        {   /* from V */
+            {0, 0, 0, 0},
+            {0, 1, 1, 2},
+            {1, 2, 2, 2},
+        },
+        {   /* from vi */
+            {0, 0, 0, 1},
+            {0, 1, 1, 2},
+            {1, 2, 2, 2},
+        },
+        {   /* from IV */
+            {0, 0, 0, 0},
+            {0, 0, 0, 1},
+            {0, 1, 1, 2},
+        },
+    },
+    {   /* B */
+        {   /* from I */
+            {0, 1, 1, 2},
+            {1, 2, 2, 2},
+            {2, 2, 2, 2},
+        },
+        {   /* from V */
+            {0, 0, 0, 0},
+            {0, 1, 1, 2},
+            {1, 2, 2, 2},
+        },
+        {   /* from vi */
+            {0, 0, 0, 1},
+            {0, 1, 1, 2},
+            {1, 2, 2, 2},
+        },
+        {   /* from IV */
+            {0, 0, 0, 0},
+            {0, 0, 0, 1},
+            {0, 1, 1, 2},
+        },
+    },
+};
+
+/* closest seventh chord inversion, [key][current chord][current inversion][next chord] */
+const uint8_t voicings_lead_seventh[VOICING_KEYS][VOICING_DEGREES][4][VOICING_DEGREES] PROGMEM = {
+    {   /* C */
+        {   /* from I */
+            {0, 2, 1, 2},
+            {1, 3, 2, 3},
+            {2, 3, 3, 3},
+            {3, 3, 3, 3},
+        },
+        {   /* from V */
+            {0, 0, 0, 1},
+            {0, 1, 0, 2},
+            {0, 2, 1, 3},
+            {1, 3, 2, 3},
+        },
+        {   /* from vi */
+            {0, 1, 0, 1},
+            {0, 2, 1, 2},
+            {1, 3, 2, 3},
+            {2, 3, 3, 3},
+        },
+        {   /* from IV */
+            {0, 0, 0, 0},
+            {0, 0, 0, 1},
+            {0, 1, 1, 2},
+            {1, 2, 2, 3},
+        },
+    },
+    {   /* C# */
+        {   /* from I */
+            {0, 2, 1, 2},
+            {1, 3, 2, 3},
+            {2, 3, 3, 3},
+            {3, 3, 3, 3},
+        },
+        {   /* from V */
+            {0, 0, 0, 1},
+            {0, 1, 0, 2},
+            {0, 2, 1, 3},
+            {1, 3, 2, 3},
+        },
+        {   /* from vi */
+            {0, 1, 0, 1},
+            {0, 2, 1, 2},
+            {1, 3, 2, 3},
+            {2, 3, 3, 3},
+        },
+        {   /* from IV */
+            {0, 0, 0, 0},
+            {0, 0, 0, 1},
+            {0, 1, 1, 2},
+            {1, 2, 2, 3},
+        },
+    },
+    {   /* D */
+        {   /* from I */
+            {0, 2, 1, 2},
+            {1, 3, 2, 3},
+            {2, 3, 3, 3},
+            {3, 3, 3, 3},
+        },
+        {   /* from V */
+            {0, 0, 0, 1},
+            {0, 1, 0, 2},
+            {0, 2, 1, 3},
+            {1, 3, 2, 3},
+        },
+        {   /* from vi */
+            {0, 1, 0, 1},
+            {0, 2, 1, 2},
+            {1, 3, 2, 3},
+            {2, 3, 3, 3},
+        },
+        {   /* from IV */
+            {0, 0, 0, 0},
+            {0, 0, 0, 1},
+            {0, 1, 1, 2},
+            {1, 2, 2, 3},
+        },
+    },
+    {   /* D# */
+        {   /* from I */
+            {0, 2, 1, 2},
+            {1, 3, 2, 3},
+            {2, 3, 3, 3},
+            {3, 3, 3, 3},
+        },
+        {   /* from V */
+            {0, 0, 0, 1},
+            {0, 1, 0, 2},
+            {0, 2, 1, 3},
+            {1, 3, 2, 3},
+        },
+        {   /* from vi */
+            {0, 1, 0, 1},
+            {0, 2, 1, 2},
+            {1, 3, 2, 3},
+            {2, 3, 3, 3},
+        },
+        {   /* from IV */
+            {0, 0, 0, 0},
+            {0, 0, 0, 1},
+            {0, 1, 1, 2},
+            {1, 2, 2, 3},
+        },
+    },
+    {   /* E */
+        {   /* from I */
+            {0, 2, 1, 2},
+            {1, 3, 2, 3},
+            {2, 3, 3, 3},
+            {3, 3, 3, 3},
+        },
+        {   /* from V */
+            {0, 0, 0, 1},
+            {0, 1, 0, 2},
+            {0, 2, 1, 3},
+            {1, 3, 2, 3},
+        },
+        {   /* from vi */
+            {0, 1, 0, 1},
+            {0, 2, 1, 2},
+            {1, 3, 2, 3},
+            {2, 3, 3, 3},
+        },
+        {   /* from IV */
+            {0, 0, 0, 0},
+            {0, 0, 0, 1},
+            {0, 1, 1, 2},
+            {1, 2, 2, 3},
+        },
+    },
+    {   /* F */
+        {   /* from I */
+            {0, 2, 1, 2},
+            {1, 3, 2, 3},
+            {2, 3, 3, 3},
+            {3, 3, 3, 3},
+        },
+        {   /* from V */
+            {0, 0, 0, 1},
+            {0, 1, 0, 2},
+            {0, 2, 1, 3},
+            {1, 3, 2, 3},
+        },
+        {   /* from vi */
+            {0, 1, 0, 1},
+            {0, 2, 1, 2},
+            {1, 3, 2, 3},
+            {2, 3, 3, 3},
+        },
+        {   /* from IV */
+            {0, 0, 0, 0},
+            {0, 0, 0, 1},
+            {0, 1, 1, 2},
+            {1, 2, 2, 3},
+        },
+    },
+    {   /* F# */
+        {   /* from I */
+            {0, 2, 1, 2},
+            {1, 3, 2, 3},
+            {2, 3, 3, 3},
+            {3, 3, 3, 3},
+        },
+        {   /* from V */
+            {0, 0, 0, 1},
+            {0, 1, 0, 2},
+            {0, 2, 1, 3},
+            {1, 3, 2, 3},
+        },
+        {   /* from vi */
+            {0, 1, 0, 1},
+            {0, 2, 1, 2},
+            {1, 3, 2, 3},
+            {2, 3, 3, 3},
+        },
+        {   /* from IV */
+            {0, 0, 0, 0},
+            {0, 0, 0, 1},
+            {0, 1, 1, 2},
+            {1, 2, 2, 3},
+        },
+    },
+    {   /* G */
+        {   /* from I */
+            {0, 0, 0, 0},
+            {1, 0, 0, 0},
+            {2, 0, 0, 0},
+            {3, 1, 0, 1},
+        },
+        {   /* from V */
+            {2, 0, 0, 1},
+            {3, 1, 0, 2},
+            {3, 2, 1, 3},
+            {3, 3, 2, 3},
+        },
+        {   /* from vi */
+            {3, 1, 0, 1},
+            {3, 2, 1, 2},
+            {3, 3, 2, 3},
+            {3, 3, 3, 3},
+        },
+        {   /* from IV */
+            {2, 0, 0, 0},
+            {3, 0, 0, 1},
+            {3, 1, 1, 2},
+            {3, 2, 2, 3},
+        },
+    },
+    {   /* G# */
+        {   /* from I */
+            {0, 0, 0, 0},
+            {1, 0, 0, 0},
+            {2, 0, 0, 0},
+            {3, 1, 0, 1},
+        },
+        {   /* from V */
+            {2, 0, 0, 1},
+            {3, 1, 0, 2},
+            {3, 2, 1, 3},
+            {3, 3, 2, 3},
+        },
+        {   /* from vi */
+            {3, 1, 0, 1},
+            {3, 2, 1, 2},
+            {3, 3, 2, 3},
+            {3, 3, 3, 3},
+        },
+        {   /* from IV */
+            {2, 0, 0, 0},
+            {3, 0, 0, 1},
+            {3, 1, 1, 2},
+            {3, 2, 2, 3},
+        },
+    },
+    {   /* A */
+        {   /* from I */
+            {0, 0, 0, 0},
+            {1, 0, 0, 0},
+            {2, 0, 0, 0},
+            {3, 1, 0, 1},
+        },
+        {   /* from V */
+            {2, 0, 0, 1},
+            {3, 1, 0, 2},
+            {3, 2, 1, 3},
+            {3, 3, 2, 3},
+        },
+        {   /* from vi */
+            {3, 1, 0, 1},
+            {3, 2, 1, 2},
+            {3, 3, 2, 3},
+            {3, 3, 3, 3},
+        },
+        {   /* from IV */
+            {2, 0, 0, 0},
+            {3, 0, 0, 1},
+            {3, 1, 1, 2},
+            {3, 2, 2, 3},
+        },
+    },
+    {   /* Bb */
+        {   /* from I */
+            {0, 2, 1, 2},
+            {1, 3, 2, 3},
+            {2, 3, 3, 3},
+            {3, 3, 3, 3},
+        },
+        {   /* from V */
+            {0, 0, 0, 1},
+            {0, 1, 0, 2},
+            {0, 2, 1, 3},
+            {1, 3, 2, 3},
+        },
+        {   /* from vi */
+            {0, 1, 0, 1},
+            {0, 2, 1, 2},
+            {1, 3, 2, 3},
+            {2, 3, 3, 3},
+        },
+        {   /* from IV */
+            {0, 0, 0, 0},
+            {0, 0, 0, 1},
+            {0, 1, 1, 2},
+            {1, 2, 2, 3},
+        },
+    },
+    {   /* B */
+        {   /* from I */
+            {0, 2, 1, 2},
+            {1, 3, 2, 3},
+            {2, 3, 3, 3},
+            {3, 3, 3, 3},
+        },
+        {   /* from V */
+            {0, 0, 0, 1},
+            {0, 1, 0, 2},
+            {0, 2, 1, 3},
+            {1, 3, 2, 3},
+        },
+        {   /* from vi */
+            {0, 1, 0, 1},
+            {0, 2, 1, 2},
+            {1, 3, 2, 3},
+            {2, 3, 3, 3},
+        },
+        {   /* from IV */
+            {0, 0, 0, 0},
+            {0, 0, 0, 1},
+            {0, 1, 1, 2},
+            {1, 2, 2, 3},
+        },
+    },
+};
+
@@ -0,0 +1,28 @@
+/*
+ * chord voicing tables
+ * auto-generated by voicegen
+ */
+#ifndef VOICINGS_H
+#define VOICINGS_H
+#include <stdint.h>
+
+#define VOICING_KEYS 12
+#define VOICING_DEGREES 4
+#define VOICING_TRIAD_INVERSIONS 3
+#define VOICING_TRIAD_NOTES 4
+#define VOICING_SEVENTH_INVERSIONS 4
+#define VOICING_SEVENTH_NOTES 5
+
+/* triads plus octave, [key][chord][inversion][note] */
+extern const uint8_t voicings_triad[VOICING_KEYS][VOICING_DEGREES][3][4];
+
+/* seventh chords plus octave, [key][chord][inversion][note] */
+extern const uint8_t voicings_seventh[VOICING_KEYS][VOICING_DEGREES][4][5];
+
+/* closest triad inversion, [key][current chord][current inversion][next chord] */
+extern const uint8_t voicings_lead_triad[VOICING_KEYS][VOICING_DEGREES][3][VOICING_DEGREES];
+
+/* closest seventh chord inversion, [key][current chord][current inversion][next chord] */
+extern const uint8_t voicings_lead_seventh[VOICING_KEYS][VOICING_DEGREES][4][VOICING_DEGREES];
+
+#endif
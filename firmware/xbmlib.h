@@ -28,6 +28,15 @@
 #define TYPE_DIFF 1
 /** struct xbmlib_frame key diff frame graphic type */
 #define TYPE_KEY_DIFF 2
+/**
+ * struct xbmlib_frame run-length encoded frame graphic type
+ *
+ * The data is a plain byte array of blocks, each starting with a control
+ * byte. A control byte 0x00..0x7f is followed by control + 1 literal
+ * bytes, a control byte 0x80..0xff by a single byte that is repeated
+ * (control & 0x7f) + 2 times.
+ */
+#define TYPE_RLE 3
 
 struct xbmlib_diff {
     uint8_t addr;
@@ -0,0 +1,237 @@
+/*
+ * voicegen 4chord MIDI chord voicing table generator
+ *
+ * Copyright (C) 2020 Sven Gregori <sven@craplab.fi>
+ * Released under GPLv2
+ *
+ * Generates the chord voicing tables for every key, each of the four
+ * chords of the progression (I, V, vi, IV), every inversion, and with or
+ * without an added seventh. Each voicing lists its MIDI notes from lowest
+ * to highest, so the firmware only needs to look up the notes when a chord
+ * button is pressed.
+ *
+ * Triads are voiced with the lowest note doubled an octave up on top, so
+ * root position is root, third, fifth, octave. Chords with added seventh
+ * are voiced the same way, i.e. root, third, fifth, seventh, octave. Each
+ * inversion moves the lowest chord tone up an octave.
+ *
+ * For voice leading, there is also a table for each chord type listing
+ * which inversion of the next chord is the closest one to the currently
+ * played voicing, i.e. the one with the least total note movement.
+ *
+ * Header file definitions of the generated data are written to stderr,
+ * the data itself to stdout.
+ *
+ * Note, like xbmgen, the generated code is meant for 8-bit AVR with
+ * avr-gcc as compiler, the tables end up in program memory.
+ *
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define KEYS    12
+#define DEGREES 4
+
+/* number of chord tones without the octave on top */
+#define TRIAD_TONES     3
+#define SEVENTH_TONES   4
+
+static const char *key_names[KEYS] = {
+    "C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "Bb", "B"
+};
+
+static const char *degree_names[DEGREES] = {"I", "V", "vi", "IV"};
+
+/* root notes for each chord (I, V, vi, IV) in all keys (C..B) */
+static const uint8_t root_notes[KEYS][DEGREES] = {
+    {48, 43, 45, 41},   /* C3   G2  A2  F2  */
+    {49, 44, 46, 42},   /* C#3  G#2 Bb2 F#2 */
+    {50, 45, 47, 43},   /* D3   A2  B2  G2  */
+    {51, 46, 48, 44},   /* D#3  Bb2 C3  G#2 */
+    {52, 47, 49, 45},   /* E3   B2  C#3 A2  */
+    {53, 48, 50, 46},   /* F3   C3  D3  Bb2 */
+    {54, 49, 51, 47},   /* F#3  C#3 D#3 B2  */
+    {43, 50, 52, 48},   /* G2   D3  E3  C3  */
+    {44, 51, 53, 49},   /* G#2  D#3 F3  C#3 */
+    {45, 52, 54, 50},   /* A2   E3  F#3 D3  */
+    {46, 41, 43, 39},   /* Bb2  F2  G2  D#2 */
+    {47, 42, 44, 40}    /* B2   F#2 G#2 E2  */
+};
+
+/*
+ * chord tone offsets from the root for each chord (I, V, vi, IV)
+ * major triad with major seventh for I and IV, dominant seventh for V,
+ * and minor triad with minor seventh for vi
+ */
+static const uint8_t tone_offsets[DEGREES][SEVENTH_TONES] = {
+    {0, 4, 7, 11},
+    {0, 4, 7, 10},
+    {0, 3, 7, 10},
+    {0, 4, 7, 11},
+};
+
+
+/**
+ * Create the voicing of a given chord and inversion.
+ *
+ * @param notes Output array, needs to hold tones + 1 notes
+ * @param key Key index
+ * @param degree Chord index within the progression
+ * @param tones Number of chord tones, TRIAD_TONES or SEVENTH_TONES
+ * @param inversion Inversion, 0 for root position
+ */
+static void
+voicing(uint8_t *notes, int key, int degree, int tones, int inversion)
+{
+    uint8_t root = root_notes[key][degree];
+    int i;
+    int tone;
+
+    for (i = 0; i < tones; i++) {
+        tone = (i + inversion) % tones;
+        notes[i] = root + tone_offsets[degree][tone];
+        if (i + inversion >= tones) {
+            notes[i] += 12;
+        }
+    }
+    notes[tones] = notes[0] + 12;
+}
+
+/**
+ * Print a voicing table for the given number of chord tones.
+ *
+ * @param name Table variable name
+ * @param tones Number of chord tones, TRIAD_TONES or SEVENTH_TONES
+ */
+static void
+print_table(const char *name, int tones)
+{
+    uint8_t notes[SEVENTH_TONES + 1];
+    int key;
+    int degree;
+    int inversion;
+    int i;
+
+    printf("const uint8_t %s[VOICING_KEYS][VOICING_DEGREES][%d][%d] PROGMEM = {\n",
+            name, tones, tones + 1);
+    fprintf(stderr, "extern const uint8_t %s[VOICING_KEYS][VOICING_DEGREES][%d][%d];\n",
+            name, tones, tones + 1);
+
+    for (key = 0; key < KEYS; key++) {
+        printf("    {   /* %s */\n", key_names[key]);
+        for (degree = 0; degree < DEGREES; degree++) {
+            printf("        {   /* %s */\n", degree_names[degree]);
+            for (inversion = 0; inversion < tones; inversion++) {
+                voicing(notes, key, degree, tones, inversion);
+                printf("            {");
+                for (i = 0; i <= tones; i++) {
+                    printf("%s%3d", (i > 0) ? ", " : "", notes[i]);
+                }
+                printf("},\n");
+            }
+            printf("        },\n");
+        }
+        printf("    },\n");
+    }
+    printf("};\n\n");
+}
+
+/**
+ * Print a voice leading table for the given number of chord tones.
+ *
+ * For each key, chord, and inversion currently played, the table lists
+ * the inversion of each next chord that has the smallest sum of note
+ * distances to it. If two inversions are equally close, the lower one
+ * is used.
+ *
+ * @param name Table variable name
+ * @param tones Number of chord tones, TRIAD_TONES or SEVENTH_TONES
+ */
+static void
+print_lead_table(const char *name, int tones)
+{
+    uint8_t from[SEVENTH_TONES + 1];
+    uint8_t to[SEVENTH_TONES + 1];
+    int key;
+    int degree;
+    int inversion;
+    int next;
+    int next_inversion;
+    int best;
+    int best_distance;
+    int distance;
+    int i;
+
+    printf("const uint8_t %s[VOICING_KEYS][VOICING_DEGREES][%d][VOICING_DEGREES] PROGMEM = {\n",
+            name, tones);
+    fprintf(stderr, "extern const uint8_t %s[VOICING_KEYS][VOICING_DEGREES][%d][VOICING_DEGREES];\n",
+            name, tones);
+
+    for (key = 0; key < KEYS; key++) {
+        printf("    {   /* %s */\n", key_names[key]);
+        for (degree = 0; degree < DEGREES; degree++) {
+            printf("        {   /* from %s */\n", degree_names[degree]);
+            for (inversion = 0; inversion < tones; inversion++) {
+                voicing(from, key, degree, tones, inversion);
+                printf("            {");
+                for (next = 0; next < DEGREES; next++) {
+                    best = 0;
+                    best_distance = -1;
+                    for (next_inversion = 0; next_inversion < tones; next_inversion++) {
+                        voicing(to, key, next, tones, next_inversion);
+                        distance = 0;
+                        for (i = 0; i <= tones; i++) {
+                            distance += abs(to[i] - from[i]);
+                        }
+                        if (best_distance < 0 || distance < best_distance) {
+                            best = next_inversion;
+                            best_distance = distance;
+                        }
+                    }
+                    printf("%s%d", (next > 0) ? ", " : "", best);
+                }
+                printf("},\n");
+            }
+            printf("        },\n");
+        }
+        printf("    },\n");
+    }
+    printf("};\n\n");
+}
+
+int
+main(void)
+{
+    printf("/*\n * chord voicing tables\n * auto-generated by voicegen\n */\n");
+    printf("#include <avr/pgmspace.h>\n#include <stdint.h>\n#include \"voicings.h\"\n\n");
+
+    fprintf(stderr, "/*\n * chord voicing tables\n * auto-generated by voicegen\n */\n");
+    fprintf(stderr, "#ifndef VOICINGS_H\n#define VOICINGS_H\n#include <stdint.h>\n\n");
+    fprintf(stderr, "#define VOICING_KEYS %d\n", KEYS);
+    fprintf(stderr, "#define VOICING_DEGREES %d\n", DEGREES);
+    fprintf(stderr, "#define VOICING_TRIAD_INVERSIONS %d\n", TRIAD_TONES);
+    fprintf(stderr, "#define VOICING_TRIAD_NOTES %d\n", TRIAD_TONES + 1);
+    fprintf(stderr, "#define VOICING_SEVENTH_INVERSIONS %d\n", SEVENTH_TONES);
+    fprintf(stderr, "#define VOICING_SEVENTH_NOTES %d\n\n", SEVENTH_TONES + 1);
+
+    printf("/* triads plus octave, [key][chord][inversion][note] */\n");
+    fprintf(stderr, "/* triads plus octave, [key][chord][inversion][note] */\n");
+    print_table("voicings_triad", TRIAD_TONES);
+
+    printf("/* seventh chords plus octave, [key][chord][inversion][note] */\n");
+    fprintf(stderr, "\n/* seventh chords plus octave, [key][chord][inversion][note] */\n");
+    print_table("voicings_seventh", SEVENTH_TONES);
+
+    printf("/* closest triad inversion, [key][current chord][current inversion][next chord] */\n");
+    fprintf(stderr, "\n/* closest triad inversion, [key][current chord][current inversion][next chord] */\n");
+    print_lead_table("voicings_lead_triad", TRIAD_TONES);
+
+    printf("/* closest seventh chord inversion, [key][current chord][current inversion][next chord] */\n");
+    fprintf(stderr, "\n/* closest seventh chord inversion, [key][current chord][current inversion][next chord] */\n");
+    print_lead_table("voicings_lead_seventh", SEVENTH_TONES);
+
+    fprintf(stderr, "\n#endif\n");
+
+    return 0;
+}
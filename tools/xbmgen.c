@@ -11,9 +11,10 @@
  *
  * Depending on the defines in the xbmgen.h header file and other extra
  * defines passed as flags to gcc from xbmtool.sh, this code will create
- * either a full frame uint8_t array, a key diff frame struct, or a diff
- * frame struct, prefilled with the raw data that can be written as-is to
- * the LCD. Either way, the XBM input file is rotated 90 degree counter
+ * either a full frame uint8_t array, a key diff frame struct, a diff
+ * frame struct, or a run-length encoded uint8_t array, prefilled with the
+ * data that can be written as-is to the LCD, or decoded on the fly while
+ * writing it. Either way, the XBM input file is rotated 90 degree counter
  * clockwise, flipped vertically, and then transformed to match the LCD
  * controller's memory arrangements. Header file definitions of the
  * generated data are written to stderr, the data itself to stdout.
@@ -21,6 +22,9 @@
  * For operation modes and how the defines relate to them, check the
  * comments with the main() function at the very end of the file.
  *
+ * If a file name is given as parameter, a line with the chosen type and
+ * the size compared to the full frame is appended to it for each graphic.
+ *
  * Note, this file is currently hardcoded to generate C code for 8-bit
  * AVR microcontrollers with avr-gcc as compiler. Data itself is defined
  * to end up in program memory using the PROGMEM attribute. Eventually,
@@ -38,6 +42,17 @@
 #define DIFF_REALLOC 16
 #define BYTES_PER_DIFF 2
 
+/*
+ * Run-length encoding, see also xbmlib.h
+ *
+ * A control byte 0x00..0x7f is followed by control + 1 literal bytes,
+ * a control byte 0x80..0xff by a single byte repeated (control & 0x7f) + 2
+ * times. Runs shorter than RLE_RUN_MIN are kept within the literal bytes.
+ */
+#define RLE_LITERAL_MAX 128
+#define RLE_RUN_MIN     3
+#define RLE_RUN_MAX     129
+
 struct diff {
     uint16_t addr;
     uint8_t data;
@@ -56,7 +71,10 @@ struct key_diff_frame {
 #define TYPE_FULL 0
 #define TYPE_DIFF 1
 #define TYPE_KEY_DIFF 2
-#define TYPE_NONE 3
+#define TYPE_RLE 3
+#define TYPE_NONE 4
+
+static const char *type_names[] = {"full", "diff", "key-diff", "rle", "none"};
 
 
 /**
@@ -229,6 +247,9 @@ print_full_frame(uint8_t *buffer, size_t buflen)
 #endif
     fprintf(stderr, "extern const uint8_t %s[];\n\n", framename);
     fprintf(stdout, "const uint8_t %s[] PROGMEM = {", framename);
+#ifdef COMPRESSED_GRAPHICS
+    fprintf(stdout, "\n        TYPE_FULL,");
+#endif
 
     for (i = 0; i < buflen; i++) {
         if (i % 8 == 0) {
@@ -298,6 +319,23 @@ print_key_diff_frame(struct key_diff_frame *key_diff_frame)
 #else
     fprintf(stderr, "/* key diff frame for %s */\n", xbm_file);
     fprintf(stdout, "/* key diff frame for %s */\n", xbm_file);
+#endif
+#ifdef COMPRESSED_GRAPHICS
+    /* same layout as the struct, as plain byte array with the type first */
+    fprintf(stderr, "extern const uint8_t %s[];\n\n", framename);
+    fprintf(stdout, "const uint8_t %s[] PROGMEM = {\n", framename);
+    fprintf(stdout, "        TYPE_KEY_DIFF, 0x%02x, %d,", key_diff_frame->base_value, frame->diffcnt);
+
+    for (i = 0; i < frame->diffcnt; i++) {
+        if (i % 4 == 0) {
+            fprintf(stdout, "\n        ");
+        }
+        diff = &frame->diffs[i];
+        fprintf(stdout, "%3d, 0x%02x, ", (diff->addr & 0xff), diff->data);
+    }
+
+    fprintf(stdout, "\n};\n\n");
+    return;
 #endif
     fprintf(stderr, "extern const struct xbmlib_key_diff_frame %s;\n\n", framename);
     fprintf(stdout, "const struct xbmlib_key_diff_frame %s PROGMEM = {\n", framename);
@@ -322,6 +360,131 @@ print_key_diff_frame(struct key_diff_frame *key_diff_frame)
     fprintf(stdout, "\n    }\n};\n\n");
 }
 
+/**
+ * Print out run-length encoded frame C code.
+ * Code for .c file is written to stdout, header file code to stderr.
+ *
+ * @param buffer run-length encoded frame data
+ * @param buflen size of run-length encoded frame data
+ */
+void
+print_rle_frame(uint8_t *buffer, size_t buflen)
+{
+    size_t i;
+
+#ifdef DIFF_FRAME
+    fprintf(stderr, "/* rle frame for %s */\n", xbm_file2);
+    fprintf(stdout, "/* rle frame for %s */\n", xbm_file2);
+#else
+    fprintf(stderr, "/* rle frame for %s */\n", xbm_file);
+    fprintf(stdout, "/* rle frame for %s */\n", xbm_file);
+#endif
+    fprintf(stderr, "extern const uint8_t %s[];\n\n", framename);
+    fprintf(stdout, "const uint8_t %s[] PROGMEM = {", framename);
+#ifdef COMPRESSED_GRAPHICS
+    fprintf(stdout, "\n        TYPE_RLE,");
+#endif
+
+    for (i = 0; i < buflen; i++) {
+        if (i % 8 == 0) {
+            fprintf(stdout, "\n        ");
+        }
+        fprintf(stdout, "0x%02x, ", buffer[i]);
+    }
+
+    fprintf(stdout, "\n};\n\n");
+}
+
+/**
+ * Run-length encode the given LCD memory data.
+ *
+ * Since the data is arranged in LCD memory order, each run is a span of
+ * identical columns within a row, continuing into the next row. Empty
+ * and evenly filled areas, which most graphics mostly consist of, end up
+ * as a few bytes that way.
+ *
+ * @param in LCD memory data to encode
+ * @param inlen size of the LCD memory data
+ * @param out output buffer, needs to hold inlen + inlen / 128 + 1 bytes
+ * @return size of the encoded data
+ */
+size_t
+rle_encode(uint8_t *in, size_t inlen, uint8_t *out)
+{
+    size_t i = 0;
+    size_t outlen = 0;
+    size_t run;
+    size_t literal_start = 0;
+    size_t literal_count = 0;
+
+    while (i < inlen) {
+        for (run = 1; i + run < inlen && run < RLE_RUN_MAX; run++) {
+            if (in[i + run] != in[i]) {
+                break;
+            }
+        }
+
+        if (run >= RLE_RUN_MIN) {
+            if (literal_count > 0) {
+                out[outlen++] = literal_count - 1;
+                memcpy(&out[outlen], &in[literal_start], literal_count);
+                outlen += literal_count;
+                literal_count = 0;
+            }
+            out[outlen++] = 0x80 | (run - 2);
+            out[outlen++] = in[i];
+            i += run;
+
+        } else {
+            if (literal_count == 0) {
+                literal_start = i;
+            }
+            literal_count++;
+            i++;
+
+            if (literal_count == RLE_LITERAL_MAX) {
+                out[outlen++] = literal_count - 1;
+                memcpy(&out[outlen], &in[literal_start], literal_count);
+                outlen += literal_count;
+                literal_count = 0;
+            }
+        }
+    }
+
+    if (literal_count > 0) {
+        out[outlen++] = literal_count - 1;
+        memcpy(&out[outlen], &in[literal_start], literal_count);
+        outlen += literal_count;
+    }
+
+    return outlen;
+}
+
+/**
+ * Creates run-length encoded frame data from xbm image.
+ *
+ * @param rlelen pointer to store the size of the encoded data in
+ * @return encoded data, to be freed by the caller
+ */
+uint8_t *
+get_rle_frame(size_t *rlelen)
+{
+    size_t buflen = frame_size();
+    uint8_t *rotbuf = calloc(1, buflen);
+    uint8_t *outbuf = calloc(1, buflen);
+    uint8_t *rlebuf = calloc(1, buflen + buflen / RLE_LITERAL_MAX + 1);
+
+    rotate_flip(xbmgen_frame2_data, rotbuf);
+    arrange_mem(rotbuf, outbuf, buflen);
+
+    *rlelen = rle_encode(outbuf, buflen, rlebuf);
+
+    free(outbuf);
+    free(rotbuf);
+
+    return rlebuf;
+}
+
 /**
  * Creates full frame char array from xbm image.
  */
@@ -475,13 +638,43 @@ get_key_diff_frame(struct key_diff_frame *key_diff_frame)
     free(outbuf);
 }
 
+/**
+ * Append the chosen frame type and size to the given report file.
+ *
+ * @param report report file name, nothing is reported if NULL
+ * @param type chosen frame type
+ * @param size size of the chosen frame in bytes
+ */
+void
+report_frame(const char *report, int type, size_t size)
+{
+    FILE *fp;
+
+    if (report == NULL || (fp = fopen(report, "a")) == NULL) {
+        return;
+    }
+
+    fprintf(fp, "%s %s %zu %zu\n", framename, type_names[type],
+            frame_size(), size);
+    fclose(fp);
+}
+
 /**
  * Stitch it all together.
  *
  * #defines used to determine operation mode and their origin:
- *      DIFF_FRAME        defined in xbmgen.h generated by xbmtool.sh
- *      LAST_DIFF_FRAME   given as gcc flag by xbmtool.sh
- *      MIXED_GRAPHICS    given as gcc flag by xbmtool.sh
+ *      DIFF_FRAME          defined in xbmgen.h generated by xbmtool.sh
+ *      LAST_DIFF_FRAME     given as gcc flag by xbmtool.sh
+ *      MIXED_GRAPHICS      given as gcc flag by xbmtool.sh
+ *      COMPRESSED_GRAPHICS given as gcc flag by xbmtool.sh
+ *
+ * The size of each approach is its data size in bytes:
+ *      full frame      frame size
+ *      key diff frame  2 + 2 bytes per diff
+ *      diff frame      1 + 2 bytes per diff
+ *      rle frame       encoded data size
+ * Diff based approaches are only considered with less than
+ * max_diff_benefit() diffs, as the diff count is stored in a single byte.
  *
  *
  * Execution order by operation mode:
@@ -494,9 +687,16 @@ get_key_diff_frame(struct key_diff_frame *key_diff_frame)
  *  -g mixed frame graphics set:
  *      all frames:
  *      DIFF_FRAME=0  LAST_DIFF_FRAME=0  MIXED_GRAPHICS=1
- *          1  Create key diff frame information
- *          2a Create key diff frame struct if approach is beneficial
- *          2b Create full frame char array otherwise
+ *          1  Create key diff and rle frame information
+ *          2  Create whichever of full frame char array, key diff frame
+ *             struct, or rle frame char array is the smallest
+ *
+ *  -c compressed graphics set:
+ *      all frames:
+ *      DIFF_FRAME=0  LAST_DIFF_FRAME=0  MIXED_GRAPHICS=1
+ *      COMPRESSED_GRAPHICS=1
+ *          see mixed frame graphics set, but every graphic is created as
+ *          char array with its frame type as first byte
  *
  *  -a one-shot animation:
  *      first frame:
@@ -505,12 +705,10 @@ get_key_diff_frame(struct key_diff_frame *key_diff_frame)
  *
  *      all other frames:
  *      DIFF_FRAME=1  LAST_DIFF_FRAME=0  MIXED_GRAPHICS=0
- *          1  Create key diff frame information
- *          2  Create transition diff frame information
- *          3a Create transition diff struct if approach is more benficial
- *             than key diff frame, and is within max_diff_benefit
- *          3b Create key diff frame if approach is within max_diff_benefit
- *          3c Create full frame char array otherwise
+ *          1  Create key diff, transition diff, and rle frame information
+ *          2  Create whichever of full frame char array, key diff frame
+ *             struct, transition diff struct, or rle frame char array is
+ *             the smallest
  *
  *  -l looping animation:
  *      first frame:
@@ -523,37 +721,55 @@ get_key_diff_frame(struct key_diff_frame *key_diff_frame)
  *
  *      last frame:
  *      DIFF_FRAME=1  LAST_DIFF_FRAME=1  MIXED_GRAPHICS=0
- *          1  Create key diff frame information
- *          2  Create transition diff frame information
- *          3a Create transition diff struct if approach is most benficial
- *          3b Create nothing at all otherwise
+ *          1  Create key diff, transition diff, and rle frame information
+ *          2a Create transition diff struct if approach is the smallest
+ *          2b Create nothing at all otherwise
  */
 int
-main(void)
+main(int argc, char *argv[])
 {
-    int ret;
+    int ret = TYPE_FULL;
+    size_t size = frame_size();
 #if defined DIFF_FRAME || defined MIXED_GRAPHICS
     struct key_diff_frame key_diff_frame;
+    uint8_t *rle;
+    size_t rle_size;
 #ifdef DIFF_FRAME
     struct frame frame;
 #endif /* DIFF_FRAME */
 
     get_key_diff_frame(&key_diff_frame);
-#ifdef DIFF_FRAME
-    get_diff_frame(&frame);
+    rle = get_rle_frame(&rle_size);
 
     /*
-     * Check if regular diff is a better choice than key diff, and if
-     * a diff based approach is the best in the first place.
-     * If so, go ahead with it and be done.
+     * Start off with the full frame and see if any other approach gets
+     * away with less data.
      */
-    if (frame.diffcnt < key_diff_frame.frame.diffcnt
-            && frame.diffcnt < max_diff_benefit())
+    if (key_diff_frame.frame.diffcnt < max_diff_benefit()
+            && (size_t) (2 + BYTES_PER_DIFF * key_diff_frame.frame.diffcnt) < size)
+    {
+        ret = TYPE_KEY_DIFF;
+        size = 2 + BYTES_PER_DIFF * key_diff_frame.frame.diffcnt;
+    }
+
+#ifdef DIFF_FRAME
+    get_diff_frame(&frame);
+
+    if (frame.diffcnt < max_diff_benefit()
+            && (size_t) (1 + BYTES_PER_DIFF * frame.diffcnt) < size)
     {
-        print_diff_frame(&frame);
         ret = TYPE_DIFF;
+        size = 1 + BYTES_PER_DIFF * frame.diffcnt;
+    }
+#endif /* DIFF_FRAME */
+
+    if (rle_size < size) {
+        ret = TYPE_RLE;
+        size = rle_size;
+    }
+
 #ifdef LAST_DIFF_FRAME
-    } else if (1) {
+    if (ret != TYPE_DIFF) {
         /*
          * Last frame in an animation that won't be using diffs, we got no
          * business here anymore. The first frame (which would be transitioned
@@ -561,34 +777,45 @@ main(void)
          * or as full frame.
          */
         ret = TYPE_NONE;
+        size = 0;
+    }
 #endif /* LAST_DIFF_FRAME */
-    } else
-#endif /* DIFF_FRAME */
-    if (key_diff_frame.frame.diffcnt < max_diff_benefit()) {
-        /*
-         * Check if a key diff approach is the better choice here.
-         * If it is, take that road and we're done.
-         */
-        print_key_diff_frame(&key_diff_frame);
-        ret = TYPE_KEY_DIFF;
 
-    } else {
+    switch (ret) {
+#ifdef DIFF_FRAME
+        case TYPE_DIFF:
+            print_diff_frame(&frame);
+            break;
+#endif /* DIFF_FRAME */
+        case TYPE_KEY_DIFF:
+            print_key_diff_frame(&key_diff_frame);
+            break;
+        case TYPE_RLE:
+            print_rle_frame(rle, rle_size);
+            break;
+        case TYPE_FULL:
 #endif /* DIFF_FRAME || MIXED_GRAPHICS */
-        /*
-         * All else failed, we're best off drawing the full frame.
-         * (also the only option for full frame graphics)
-         */
-        process_full_frame();
-        ret = TYPE_FULL;
+            /*
+             * All else failed, we're best off drawing the full frame.
+             * (also the only option for full frame graphics)
+             */
+            process_full_frame();
 #if defined DIFF_FRAME || defined MIXED_GRAPHICS
+            break;
     }
 
+    free(rle);
     free(key_diff_frame.frame.diffs);
 #ifdef DIFF_FRAME
     free(frame.diffs);
 #endif /* DIFF_FRAME */
 #endif /* DIFF_FRAME || MIXED_GRAPHICS */
 
+#ifdef COMPRESSED_GRAPHICS
+    /* frame type byte */
+    size++;
+#endif
+    report_frame((argc > 1) ? argv[1] : NULL, ret, size);
+
     return ret;
 }
-
@@ -24,7 +24,7 @@ xbmtool=$(basename $0)
 #
 function usage {
     cat << EOL
-Usage: $xbmtool [-f|-l|-a|-g] [-n <namespace>] [-o <outdir>] <xbm files>
+Usage: $xbmtool [-f|-l|-a|-g|-c] [-n <namespace>] [-o <outdir>] <xbm files>
 
 Create raw data for Nokia 3310/5110 LCD from given XBM files.
 Data can be either created as set of individual graphics, or as an
@@ -37,7 +37,16 @@ Operation mode options:
     -l  Creates a looping animation from given files
     -a  Creates a one-shot animation from given files
     -g  Creates a set of individual graphics from given files as either
-        full frame array, or key diff struct, whichever is more efficient.
+        full frame array, key diff struct, or run-length encoded array,
+        whichever is more efficient.
+    -c  Creates a set of individual graphics from given files like -g, but
+        all as plain arrays with the graphic type as first byte, so they
+        can be used interchangeably.
+
+Animation frames are created as whichever of full frame array, key diff
+struct, diff struct, or run-length encoded array is the most efficient.
+After all is done, the size of each created graphic is listed compared
+to its full frame size.
 
 Other options:
     -n <namespace>  Optionally set the name space of the generated data.
@@ -65,6 +74,7 @@ EOL
 #
 mode_graphics=0
 full_graphics=0
+compressed_graphics=0
 mode_animation=0
 loop_animation=0
 namespace="xbmlib_gfx"
@@ -73,7 +83,7 @@ outdir="$(pwd)"
 #
 # Parse and assign cli arguments accordingly
 #
-while getopts "lafghn:o:" arg; do
+while getopts "lafgchn:o:" arg; do
     case $arg in
         l)
             mode_animation=1
@@ -95,6 +105,12 @@ while getopts "lafghn:o:" arg; do
             full_graphics=0
             output_type="mixed graphics set"
             ;;
+        c)
+            mode_graphics=1
+            full_graphics=0
+            compressed_graphics=1
+            output_type="compressed graphics set"
+            ;;
         h)
             usage
             exit 0
@@ -198,6 +214,7 @@ cp $srcdir/$xbmgen_src $builddir
 # define output files
 header_output_file="$builddir/$namespace.h"
 source_output_file="$builddir/$namespace.c"
+report_file="$builddir/report"
 
 # storing type and variable name of all animation frames
 animation_frame_list=""
@@ -272,6 +289,9 @@ function create_graphic_frame {
     if [ $mode_animation -eq 1 ] || [ $full_graphics -eq 0 ] ; then
         gcc_extra_flags="-DMIXED_GRAPHICS"
     fi
+    if [ $compressed_graphics -eq 1 ] ; then
+        gcc_extra_flags+=" -DCOMPRESSED_GRAPHICS"
+    fi
 
     gcc $gcc_flags $gcc_extra_flags -o $builddir/$outfile $builddir/$xbmgen_src
 
@@ -279,7 +299,7 @@ function create_graphic_frame {
         gcc_extra_flags=""
     fi
 
-    $builddir/$outfile 2>>$header_output_file >>$source_output_file;
+    $builddir/$outfile $report_file 2>>$header_output_file >>$source_output_file;
     return $?
 }
 
@@ -355,7 +375,7 @@ function create_diff_frame {
 
     gcc $gcc_flags $gcc_extra_flags -o $builddir/$outfile $builddir/$xbmgen_src
 
-    $builddir/$outfile 2>>$header_output_file >>$source_output_file;
+    $builddir/$outfile $report_file 2>>$header_output_file >>$source_output_file;
     return $?
 }
 
@@ -377,6 +397,8 @@ function add_frame_to_list {
             frame_type="TYPE_DIFF" ;;
         2)
             frame_type="TYPE_KEY_DIFF" ;;
+        3)
+            frame_type="TYPE_RLE" ;;
         *)
             # ignore TYPE_NONE frame type, it won't be added
             return ;;
@@ -480,6 +502,16 @@ cat >> $header_output_file << EOL
 #endif
 EOL
 
+# list the size of each created graphic, skipping unused animation frames
+awk '$NF > 0 {
+        printf "    %-40s %-9s %4d -> %4d bytes\n", $1, $2, $3, $4
+        full += $3
+        size += $4
+    }
+    END {
+        printf "Total: %d -> %d bytes, saved %d bytes\n", full, size, full - size
+    }' $report_file
+
 # copy generated header and source file in current directory
 echo "Writing $output_type to $outdir_source_file and $outdir_header_file"
 cp $header_output_file $outdir